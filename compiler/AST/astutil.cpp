@@ -536,6 +536,7 @@ void insert_help(BaseAST* ast,
 void remove_help(BaseAST* ast, int trace_flag) {
   trace_remove(ast, trace_flag);
   AST_CHILDREN_CALL(ast, remove_help, trace_flag);
+  noteRemovedAst(ast);
   if (Expr* expr = toExpr(ast)) {
     expr->parentSymbol = NULL;
     expr->parentExpr = NULL;
@@ -872,13 +873,14 @@ Symbol* getSvecSymbol(CallExpr* call) {
   AggregateType* tuple = toAggregateType(type);
   SymExpr* fieldVal = toSymExpr(call->get(2));
   VarSymbol* fieldSym = toVarSymbol(fieldVal->var);
-  if (fieldSym) {
+  if (fieldSym && fieldSym->immediate) {
     int immediateVal = fieldSym->immediate->int_value();
 
     INT_ASSERT(immediateVal >= 1 && immediateVal <= tuple->fields.length);
     return tuple->getField(immediateVal);
   } else {
-    // GET_SVEC_MEMBER(p, i), where p is a star tuple
+    // GET_SVEC_MEMBER(p, i), where p is a star tuple and i is not a
+    // compile-time constant, e.g. a formal or a local after inlining
     return NULL;
   }
 }
@@ -17,6 +17,8 @@
  * limitations under the License.
  */
 
+#include <pthread.h>
+
 #include <ostream>
 #include <sstream>
 #include <string>
@@ -48,6 +50,150 @@ foreach_ast(decl_gvecs);
 
 static int uid = 1;
 
+bool astRegistryShared = false;
+
+static pthread_mutex_t astRegistryLock = PTHREAD_MUTEX_INITIALIZER;
+
+void lockAstRegistry() {
+  pthread_mutex_lock(&astRegistryLock);
+}
+
+void unlockAstRegistry() {
+  pthread_mutex_unlock(&astRegistryLock);
+}
+
+static int nextAstId() {
+  int id = 0;
+
+  if (astRegistryShared) {
+    lockAstRegistry();
+    id = uid++;
+    unlockAstRegistry();
+  } else {
+    id = uid++;
+  }
+
+  return id;
+}
+
+//
+// Count the nodes of each kind as they are constructed and destroyed.
+// PhaseTracker samples these between phases to report what each pass
+// allocated.
+//
+static long astCreated[AST_TAG_COUNT];
+static long astDestroyed[AST_TAG_COUNT];
+
+static inline void countAst(long* counter) {
+  if (astRegistryShared)
+    __sync_fetch_and_add(counter, 1);
+  else
+    *counter = *counter + 1;
+}
+
+#define ast_tag_name(type)                      \
+  case E_##type: return #type
+
+const char* astTagName(AstTag tag) {
+  switch (tag) {
+    foreach_ast(ast_tag_name);
+  }
+
+  return "???";
+}
+
+#define ast_tag_size(type)                      \
+  case E_##type: return sizeof(type)
+
+static size_t astTagSize(AstTag tag) {
+  switch (tag) {
+    foreach_ast(ast_tag_size);
+  }
+
+  return 0;
+}
+
+void getAstKindCounts(AstKindCounts counts[AST_TAG_COUNT]) {
+  for (int i = 0; i < AST_TAG_COUNT; i++) {
+    counts[i].created   = astCreated[i];
+    counts[i].destroyed = astDestroyed[i];
+    counts[i].bytes     = astCreated[i] * (long) astTagSize((AstTag) i);
+  }
+}
+
+//
+// AST nodes are allocated from pools, one per size class.  A pool carves
+// fixed-size cells out of large slabs and recycles the cells of deleted
+// nodes through a free list, so the many small nodes that every pass
+// creates and drops do not each go through malloc and free.  Slabs are
+// never returned to the system.  The pools are per thread so that the
+// function passes run by --pass-threads need no locking; a cell deleted
+// on one thread simply joins that thread's free list.
+//
+#define AST_POOL_GRANULE   16
+#define AST_POOL_MAX_SIZE  1024
+#define AST_POOL_CLASSES   (AST_POOL_MAX_SIZE / AST_POOL_GRANULE)
+#define AST_POOL_SLAB_SIZE (64 * 1024)
+
+struct AstPoolCell {
+  AstPoolCell* next;
+};
+
+struct AstPool {
+  AstPoolCell* freeList;
+  char*        slab;     // next unused cell in the current slab
+  char*        slabEnd;
+};
+
+static __thread AstPool astPools[AST_POOL_CLASSES];
+static int astPoolSlabs = 0;
+
+static inline size_t astPoolClass(size_t size) {
+  return (size + AST_POOL_GRANULE - 1) / AST_POOL_GRANULE - 1;
+}
+
+void* BaseAST::operator new(size_t size) {
+  if (size > AST_POOL_MAX_SIZE)
+    return malloc(size);
+
+  size_t   sizeClass = astPoolClass(size);
+  size_t   cellSize  = (sizeClass + 1) * AST_POOL_GRANULE;
+  AstPool* pool      = &astPools[sizeClass];
+
+  if (AstPoolCell* cell = pool->freeList) {
+    pool->freeList = cell->next;
+    return cell;
+  }
+
+  if (pool->slab + cellSize > pool->slabEnd) {
+    pool->slab = (char*)malloc(AST_POOL_SLAB_SIZE);
+    if (!pool->slab)
+      INT_FATAL("out of memory allocating AST nodes");
+    pool->slabEnd = pool->slab + AST_POOL_SLAB_SIZE;
+    __sync_fetch_and_add(&astPoolSlabs, 1);
+  }
+
+  void* cell = pool->slab;
+  pool->slab += cellSize;
+  return cell;
+}
+
+void BaseAST::operator delete(void* ptr, size_t size) {
+  if (!ptr)
+    return;
+
+  if (size > AST_POOL_MAX_SIZE) {
+    free(ptr);
+    return;
+  }
+
+  AstPool*     pool = &astPools[astPoolClass(size)];
+  AstPoolCell* cell = (AstPoolCell*)ptr;
+
+  cell->next     = pool->freeList;
+  pool->freeList = cell;
+}
+
 #define decl_counters(type)                                             \
   int n##type = g##type##s.n, k##type = n##type*sizeof(type)/1024
 
@@ -61,6 +207,8 @@ void printStatistics(const char* pass) {
     if (strstr(fPrintStatistics, "m")) {
       fprintf(stderr, "Maximum # of ASTS: %d\n", maxN);
       fprintf(stderr, "Maximum Size (KB): %d\n", maxK);
+      fprintf(stderr, "AST Pool Slabs (KB): %d\n",
+              astPoolSlabs * (AST_POOL_SLAB_SIZE / 1024));
     }
   }
 
@@ -150,17 +298,91 @@ void trace_remove(BaseAST* ast, char flag) {
     INT_FATAL(ast, "Unexpected attempt to eviscerate a global type symbol.");
 }
 
+//
+// Nodes that remove_help takes out of the tree are recorded in
+// removedAsts.  cleanAst uses them to find the kinds of nodes that may
+// have died since the last clean; for the other kinds, only the nodes
+// created since then (which may never have been inserted) need to be
+// examined.  cleanedLength and cleanedLast hold the length and the last
+// node of each global vector at the end of the last clean; if a vector
+// was shortened outside of cleanAst, all of it is examined.
+//
+static Vec<BaseAST*> removedAsts;
+static int cleanedLength[E_AggregateType + 1];
+static BaseAST* cleanedLast[E_AggregateType + 1];
+static int cleanExamined = 0;
+static int cleanSkipped = 0;
+
+void noteRemovedAst(BaseAST* ast) {
+  registerAst(removedAsts, ast);
+}
+
+void cleanAstStatistics(int& examined, int& skipped) {
+  examined = cleanExamined;
+  skipped  = cleanSkipped;
+}
+
+static bool isDeadAst(BaseAST* ast) {
+  if (Expr* expr = toExpr(ast))
+    return !isAlive(expr);
+  else if (Symbol* sym = toSymbol(ast))
+    return !isAlive(sym) && !isRootModule(sym);
+  else if (Type* type = toType(ast))
+    return !isAlive(type);
+  return false;
+}
+
+//
+// A DefExpr that never made it into the tree also kills the symbol it
+// defines, and that symbol may be older than the last clean.
+//
+static void noteDeadDefinition(BaseAST* ast, bool* hasDead) {
+  if (DefExpr* def = toDefExpr(ast)) {
+    if (def->sym && def->sym->defPoint == def) {
+      hasDead[def->sym->astTag] = true;
+      if (TypeSymbol* ts = toTypeSymbol(def->sym))
+        hasDead[ts->type->astTag] = true;
+    }
+  }
+}
+
+#define find_new_dead(type)                                             \
+  if (g##type##s.n < cleanedLength[E_##type] ||                         \
+      (cleanedLength[E_##type] > 0 &&                                   \
+       g##type##s.v[cleanedLength[E_##type] - 1] != cleanedLast[E_##type])) \
+    cleanedLength[E_##type] = 0;                                        \
+  for (int i = cleanedLength[E_##type]; i < g##type##s.n; i++) {        \
+    if (isDeadAst(g##type##s.v[i])) {                                   \
+      hasDead[E_##type] = true;                                         \
+      noteDeadDefinition(g##type##s.v[i], hasDead);                     \
+    }                                                                   \
+  }                                                                     \
+  cleanExamined += g##type##s.n - cleanedLength[E_##type]
+
 #define clean_gvec(type)                        \
-  int i##type = 0;                              \
-  forv_Vec(type, ast, g##type##s) {             \
-    if (isAlive(ast) || isRootModuleWithType(ast, type)) { \
-      g##type##s.v[i##type++] = ast;            \
-    } else {                                    \
-      trace_remove(ast, 'x');                   \
-      delete ast; ast = 0;                      \
+  if (hasDead[E_##type]) {                      \
+    int i##type = 0;                            \
+    forv_Vec(type, ast, g##type##s) {           \
+      if (isAlive(ast) || isRootModuleWithType(ast, type)) { \
+        g##type##s.v[i##type++] = ast;          \
+      } else {                                  \
+        trace_remove(ast, 'x');                 \
+        delete ast; ast = 0;                    \
+      }                                         \
     }                                           \
+    cleanExamined += cleanedLength[E_##type];   \
+    g##type##s.n = i##type;                     \
+  } else {                                      \
+    cleanSkipped += cleanedLength[E_##type];    \
   }                                             \
-  g##type##s.n = i##type
+  cleanedLength[E_##type] = g##type##s.n;      \
+  cleanedLast[E_##type] = (g##type##s.n) ? g##type##s.v[g##type##s.n - 1] : 0
+
+#define verify_clean_gvec(type)                 \
+  forv_Vec(type, ast, g##type##s) {             \
+    if (!isAlive(ast) && !isRootModuleWithType(ast, type)) \
+      INT_FATAL(ast, "dead AST node survived cleanAst"); \
+  }
 
 
 static void clean_modvec(Vec<ModuleSymbol*>& modvec) {
@@ -174,26 +396,51 @@ static void clean_modvec(Vec<ModuleSymbol*>& modvec) {
 }
 
 void cleanAst() {
-  cleanModuleList();
+  bool hasDead[E_AggregateType + 1] = { false };
+
+  cleanExamined = 0;
+  cleanSkipped  = 0;
+
+  //
+  // find the kinds of nodes that have dead nodes
+  //
+  forv_Vec(BaseAST, ast, removedAsts) {
+    if (isDeadAst(ast))
+      hasDead[ast->astTag] = true;
+  }
+  cleanExamined += removedAsts.n;
+  removedAsts.clear();
+
+  foreach_ast(find_new_dead);
+
+  bool fnDied   = hasDead[E_FnSymbol];
+  bool typeDied = hasDead[E_PrimitiveType] || hasDead[E_EnumType] ||
+                  hasDead[E_AggregateType];
+
+  if (fnDied)
+    cleanModuleList();
+
   //
   // clear back pointers to dead ast instances
   //
-  forv_Vec(TypeSymbol, ts, gTypeSymbols) {
-    for(int i = 0; i < ts->type->methods.n; i++) {
-      FnSymbol* method = ts->type->methods.v[i];
-      if (method && !isAliveQuick(method))
-        ts->type->methods.v[i] = NULL;
-      if (AggregateType* ct = toAggregateType(ts->type)) {
-        if (ct->defaultInitializer && !isAliveQuick(ct->defaultInitializer))
-          ct->defaultInitializer = NULL;
-        if (ct->destructor && !isAliveQuick(ct->destructor))
-          ct->destructor = NULL;
+  if (fnDied || typeDied) {
+    forv_Vec(TypeSymbol, ts, gTypeSymbols) {
+      for(int i = 0; i < ts->type->methods.n; i++) {
+        FnSymbol* method = ts->type->methods.v[i];
+        if (method && !isAliveQuick(method))
+          ts->type->methods.v[i] = NULL;
+        if (AggregateType* ct = toAggregateType(ts->type)) {
+          if (ct->defaultInitializer && !isAliveQuick(ct->defaultInitializer))
+            ct->defaultInitializer = NULL;
+          if (ct->destructor && !isAliveQuick(ct->destructor))
+            ct->destructor = NULL;
+        }
+      }
+      for(int i = 0; i < ts->type->dispatchChildren.n; i++) {
+        Type* type = ts->type->dispatchChildren.v[i];
+        if (type && !isAlive(type))
+          ts->type->dispatchChildren.v[i] = NULL;
       }
-    }
-    for(int i = 0; i < ts->type->dispatchChildren.n; i++) {
-      Type* type = ts->type->dispatchChildren.v[i];
-      if (type && !isAlive(type))
-        ts->type->dispatchChildren.v[i] = NULL;
     }
   }
 
@@ -203,13 +450,19 @@ void cleanAst() {
 
   // clean the other module vectors, without deleting the ast instances (they
   // will be deleted with the clean_gvec call for ModuleSymbols.) 
-  clean_modvec(allModules);
-  clean_modvec(userModules);
+  if (hasDead[E_ModuleSymbol]) {
+    clean_modvec(allModules);
+    clean_modvec(userModules);
+  }
  
   //
   // clean global vectors and delete dead ast instances
   //
   foreach_ast(clean_gvec);
+
+  if (fVerify) {
+    foreach_ast(verify_clean_gvec);
+  }
 }
 
 
@@ -266,10 +519,11 @@ static void checkid(int id) {
 
 BaseAST::BaseAST(AstTag type) :
   astTag(type),
-  id(uid++),
+  id(nextAstId()),
   astloc(yystartlineno, yyfilename)
 {
   checkid(id);
+  countAst(&astCreated[type]);
   if (astloc.filename) {
     // OK, set from yyfilename
   } else {
@@ -287,6 +541,7 @@ const std::string BaseAST::tabText = "   ";
 
 
 BaseAST::~BaseAST() { 
+  countAst(&astDestroyed[astTag]);
 }
 
 int BaseAST::linenum() const {
@@ -498,7 +753,9 @@ void BaseAST::printDocsDescription(const char *doc, std::ostream *file, unsigned
 }
 
 
-astlocT currentAstLoc(0,NULL);
+static astlocT mainThreadAstLoc(0, NULL);
+
+__thread astlocT* currentAstLocPtr = &mainThreadAstLoc;
 
 Vec<ModuleSymbol*> userModules; // Contains user + main modules
 Vec<ModuleSymbol*> allModules;  // Contains all modules
@@ -29,10 +29,10 @@
 #include "view.h"
 #include "WhileDoStmt.h"
 
-int                                          BasicBlock::nextID     = 0;
-BasicBlock*                                  BasicBlock::basicBlock = NULL;
-Map<LabelSymbol*, std::vector<BasicBlock*>*> BasicBlock::gotoMaps;
-Map<LabelSymbol*, BasicBlock*>               BasicBlock::labelMaps;
+__thread int                                           BasicBlock::nextID     = 0;
+__thread BasicBlock*                                   BasicBlock::basicBlock = NULL;
+__thread Map<LabelSymbol*, std::vector<BasicBlock*>*>* BasicBlock::gotoMaps   = NULL;
+__thread Map<LabelSymbol*, BasicBlock*>*               BasicBlock::labelMaps  = NULL;
 
 BasicBlock::BasicBlock() {
   id = nextID++;
@@ -42,8 +42,13 @@ BasicBlock::BasicBlock() {
 void BasicBlock::reset(FnSymbol* fn) {
   clear(fn);
 
-  gotoMaps.clear();
-  labelMaps.clear();
+  if (gotoMaps == NULL) {
+    gotoMaps  = new Map<LabelSymbol*, std::vector<BasicBlock*>*>();
+    labelMaps = new Map<LabelSymbol*, BasicBlock*>();
+  }
+
+  gotoMaps->clear();
+  labelMaps->clear();
 
   fn->basicBlocks = new std::vector<BasicBlock*>();
 
@@ -200,20 +205,20 @@ void BasicBlock::buildBasicBlocks(FnSymbol* fn, Expr* stmt, bool mark) {
   } else if (GotoStmt* s = toGotoStmt(stmt)) {
     LabelSymbol* label = toLabelSymbol(toSymExpr(s->label)->var);
 
-    if (BasicBlock* bb = labelMaps.get(label)) {
+    if (BasicBlock* bb = labelMaps->get(label)) {
       // Thread this block to its destination label.
       thread(basicBlock, bb);
 
     } else {
       // Set up goto map, so this block's successor can be back-patched later.
-      std::vector<BasicBlock*>* vbb = gotoMaps.get(label);
+      std::vector<BasicBlock*>* vbb = gotoMaps->get(label);
 
       if (!vbb)
         vbb = new std::vector<BasicBlock*>();
 
       vbb->push_back(basicBlock);
 
-      gotoMaps.put(label, vbb);
+      gotoMaps->put(label, vbb);
     }
 
     append(s, mark); // Put the goto at the end of its block.
@@ -266,13 +271,13 @@ void BasicBlock::buildBasicBlocks(FnSymbol* fn, Expr* stmt, bool mark) {
 
       // See if we have any unresolved references to this label,
       // and resolve them.
-      if (std::vector<BasicBlock*>* vbb = gotoMaps.get(label)) {
+      if (std::vector<BasicBlock*>* vbb = gotoMaps->get(label)) {
         for_vector(BasicBlock, bb, *vbb) {
           thread(bb, basicBlock);
         }
       }
 
-      labelMaps.put(label, basicBlock);
+      labelMaps->put(label, basicBlock);
     } else {
       append(stmt, mark);
     }
@@ -418,12 +423,21 @@ void BasicBlock::buildLocalsVectorMap(FnSymbol*          fn,
 
 
 //#define DEBUG_FLOW
+//
+// The sets are combined a whole BitVec at a time so that the analyses
+// can pick the representation (dense or sparse) of their sets.  meet is
+// a scratch set for combining the sets of the neighboring blocks.
+//
 void BasicBlock::backwardFlowAnalysis(FnSymbol*             fn,
                                       std::vector<BitVec*>& GEN,
                                       std::vector<BitVec*>& KILL,
                                       std::vector<BitVec*>& IN,
                                       std::vector<BitVec*>& OUT) {
-  bool iterate = true;
+  if (IN.size() == 0)
+    return;
+
+  BitVec meet(IN[0]->size(), IN[0]->sparse);
+  bool   iterate = true;
 
   while (iterate) {
     int i = 0;
@@ -431,23 +445,18 @@ void BasicBlock::backwardFlowAnalysis(FnSymbol*             fn,
     iterate = false;
 
     for_vector(BasicBlock, bb, *fn->basicBlocks) {
-      for (size_t j = 0; j < IN[i]->ndata; j++) {
-        unsigned int new_in  = (OUT[i]->data[j] & ~KILL[i]->data[j]) | GEN[i]->data[j];
-        unsigned int new_out = 0;
+      if (IN[i]->transfer(*OUT[i], *KILL[i], *GEN[i]))
+        iterate = true;
 
-        if (new_in != IN[i]->data[j]) {
-          IN[i]->data[j] = new_in;
-          iterate = true;
-        }
+      meet.reset();
 
-        for_vector(BasicBlock, bbout, bb->outs) {
-          new_out = new_out | IN[bbout->id]->data[j];
-        }
+      for_vector(BasicBlock, bbout, bb->outs) {
+        meet.disjunction(*IN[bbout->id]);
+      }
 
-        if (new_out != OUT[i]->data[j]) {
-          OUT[i]->data[j] = new_out;
-          iterate = true;
-        }
+      if (!OUT[i]->equals(meet)) {
+        OUT[i]->copy(meet);
+        iterate = true;
       }
 
       i++;
@@ -472,6 +481,11 @@ void BasicBlock::forwardFlowAnalysis(FnSymbol*             fn,
   int              iq = -1;
   int              nq = nbbq - 1;
 
+  if (nbbq == 0)
+    return;
+
+  BitVec           meet(IN[0]->size(), IN[0]->sparse);
+
   for (size_t i = 0; i < nbbq; i++) {
     bbq.push_back(i);
     bbs.set(i);
@@ -494,31 +508,28 @@ void BasicBlock::forwardFlowAnalysis(FnSymbol*             fn,
     BasicBlock* bb     = (*fn->basicBlocks)[i];
     bool        change = false;
 
-    for (size_t j = 0; j < IN[i]->ndata; j++) {
-      if (bb->ins.size() > 0) {
-        unsigned int new_in = (intersect) ? (unsigned int) (-1) : 0;
-
-        for_vector(BasicBlock, bbin, bb->ins) {
-          if (intersect)
-            new_in &= OUT[bbin->id]->data[j];
-          else
-            new_in |= OUT[bbin->id]->data[j];
-        }
-
-        if (new_in != IN[i]->data[j]) {
-          IN[i]->data[j] = new_in;
-          change         = true;
-        }
+    if (bb->ins.size() > 0) {
+      if (intersect)
+        meet.set();
+      else
+        meet.reset();
+
+      for_vector(BasicBlock, bbin, bb->ins) {
+        if (intersect)
+          meet.intersection(*OUT[bbin->id]);
+        else
+          meet.disjunction(*OUT[bbin->id]);
       }
 
-      unsigned int new_out = (IN[i]->data[j] & ~KILL[i]->data[j]) | GEN[i]->data[j];
-
-      if (new_out != OUT[i]->data[j]) {
-        OUT[i]->data[j] = new_out;
-        change          = true;
+      if (!IN[i]->equals(meet)) {
+        IN[i]->copy(meet);
+        change = true;
       }
     }
 
+    if (OUT[i]->transfer(*IN[i], *KILL[i], *GEN[i]))
+      change = true;
+
     if (change) {
       for_vector(BasicBlock, bbout, bb->outs) {
         if (!bbs.get(bbout->id)) {
@@ -27,234 +27,218 @@
  *         look swap the exit and entry node and look at look at the "outs" of 
  *         block rather than the ins.        
  */
- 
+
 
 /*
- * This function exists so that dead or unreachable basic blocks do not screw
- * up the dominator computation. Currently in the basic block creation gotos
- * will create a basic block immediately following them, regardless as to
- * whether there is actually any code or not.  
- *
- * For the example:
- * if cond then {
- *   // stuff
- *   goto _lbl;
- *   // unreachable stuff
- * }
- * // more stuff
- * _lbl:
- *
- * we would get something like
- *
- * 0: > 1 3
- *  cond
- * 1: 0 > 4
- *  // stuff
- *  goto _lbl;
- * 2: > 3
- *  // unreachable stuff
- * 3: 0 2 > 4
- *  // more stuff
- * 4: 1 3 >
- *  _lbl:
- * 
- * In this case an extra basic block is created and if there is nothing where 
- * unreachable stuff is, then we are creating a dead empty basic block. If we
- * have two goto's that goto the same label we get two empty basic blocks that
- * have no ins and a third empty basic block that is also empty but has the two
- * other empty basic blocks as ins. For this reason we can't just say ignore
- * all basic blocks with no ins because there can be more complex cases of dead
- * blocks that have ins (from other dead basic blocks.) The dominator analysis
- * assumed that there are no dead blocks as it leads to case where dead blocks
- * dominate every other blocks, which is clearly the  opposite of the truth.
- * 
- * This was an issue for LICM, where things that were not actually loops
- * were being identified as loops. Right now these dead empty basic blocks are
- * created even if there is no actual dead code in the AST. This is a result of
- * how basic blocks are currently created. It may be changed sometime after the
- * 1.8 release, in which case this function may become unnecessary. It can be
- * removed if we can guarantee that there are no dead blocks, and that the
- * basic block creation doesn't create any artificial dead blocks. 
+ * The block with the least semidominator on the path from v up to the
+ * root of its tree in the forest built by the Lengauer-Tarjan algorithm.
+ * The path is compressed along the way; path is scratch space.
  */
-static void unsetDeadBlocks(std::vector<BitVec*>& dominators, 
-    std::vector<BasicBlock*>& basicBlocks) {
-
-  unsigned nBlocks = basicBlocks.size();
-  unsigned oldNumBlocks = ~0;
-  std::set<unsigned> deadBlocks;
-
-  //Find any dead basic blocks: blocks that have no ins, or blocks that have
-  //predecessors that have no ins. 
-  while(deadBlocks.size() != oldNumBlocks) {
-    oldNumBlocks = deadBlocks.size();
-    for(unsigned i = 1; i < nBlocks; i++) {
-      if(basicBlocks[i]->ins.size() == 0)
-        deadBlocks.insert(i);
-      
-      bool allInsAreDead = true;
-      for_vector(BasicBlock, in, basicBlocks[i]->ins) {
-        if(deadBlocks.count(in->id) == 0) {
-          allInsAreDead = false;
-        }
-      }
-      if(allInsAreDead) {
-        deadBlocks.insert(i);
-      }
-    }
+static int eval(int               v,
+                std::vector<int>& ancestor,
+                std::vector<int>& label,
+                std::vector<int>& semi,
+                std::vector<int>& path) {
+  if (ancestor[v] == -1)
+    return v;
+
+  int x = v;
+
+  while (ancestor[ancestor[x]] != -1) {
+    path.push_back(x);
+    x = ancestor[x];
   }
-  
-  //Set it so that any dead blocks are not dominated by any other blocks and
-  //that they do not dominate any blocks. 
-  for(unsigned i2 = 1; i2 < nBlocks; i2++) {
-    if(deadBlocks.count(i2) == 1) {
-      for(unsigned j2 = 1; j2 < nBlocks; j2++) {
-        dominators[j2]->reset(i2);
-      }
-      dominators[i2]->reset();
-    }
+
+  while (path.size() > 0) {
+    int y = path.back();
+    int a = ancestor[y];
+
+    path.pop_back();
+
+    if (semi[label[a]] < semi[label[y]])
+      label[y] = label[a];
+
+    ancestor[y] = ancestor[a];
   }
 
+  return label[v];
 }
 
 
 /*
- * Computes the dominators for the set of basic blocks.
- * 
- * This algorithm is based on the dominator computation in Advanced Compiler Design 
- * Implementation. While the running time is O(n^2e)for a flowgraph with n nodes and 
- * e edges this algorithm is probably the most efficient as the number of basic blocks 
- * we look at at a time is usually pretty small. There are more complex algorithms that
- * can run in near linear time, but have poor performance for computations that don't 
- * contain at least a few hundred nodes. 
- * 
- * If a node a dominates node b then dominators[b]->get(a) will be true. That is to say that
- * dominators[i] stores the set of all nodes that dominate node i
- * 
- * This algorithm will be most efficient if the basic blocks are in a depth-first order. 
+ * The dominators used to be computed as one BitVec per block by iterating
+ * to a fixed point, which is quadratic in the number of blocks and did not
+ * scale to the large functions produced by lowerIterators and inlining.
+ *
+ * The dominator tree is computed with the Lengauer-Tarjan algorithm (using
+ * simple path compression), as described in "A Fast Algorithm for Finding
+ * Dominators in a Flowgraph", Lengauer and Tarjan, TOPLAS 1979.  All of
+ * the traversals use explicit stacks so that deep flowgraphs do not
+ * overflow the C stack.
+ *
+ * Blocks that cannot be reached from the entry block are left out of the
+ * tree.  The basic block construction creates such blocks after gotos; if
+ * they were given dominators, a dead block could appear to dominate live
+ * ones, which made LICM find loops that were not there.
  */
-void computeDominators(std::vector<BitVec*>& dominators, std::vector<BasicBlock*>& basicBlocks) {
-  unsigned nBlocks = basicBlocks.size();
-  
-  //The root node cannot be dominated 
-  dominators[0]->set(0);
-  
-  //Initially set all other nodes as dominated by every other node 
-  for(unsigned i = 1; i < nBlocks; i++) {
-    dominators[i]->set();
-  }
-  
-  //Iteratively look for changes. A node a dominates b 
-  //if a = b, a is immediate predecessor of b, of i 
-  //b has multiple predecessors but a dominates 
-  //all of them.
-  bool changed = true;
-  while(changed) {
-    changed = false;
-    
-    for(unsigned i = 1; i < nBlocks; i++) {
-      BitVec temp = BitVec(nBlocks);
-      temp.set();
-      
-      BasicBlock* curBB = basicBlocks[i];
-      for(unsigned j = 0; j < curBB->ins.size(); j++) {
-        //TODO I would ideally like this to be &=
-        temp.intersection(*dominators[curBB->ins[j]->id]);        
-      }
-      temp.set(i);
-      
-      //TODO would like to implement == and != 
-      if(temp.equals(*dominators[i]) == false) {
-        changed = true;
-        dominators[i]->reset();
-        dominators[i]->disjunction(temp);
+DominatorTree::DominatorTree(std::vector<BasicBlock*>& basicBlocks) {
+  int nBlocks = basicBlocks.size();
+
+  mIdom.assign(nBlocks, -1);
+  mPre.assign(nBlocks, -1);
+  mLast.assign(nBlocks, -1);
+
+  if (nBlocks == 0)
+    return;
+
+  std::vector<int> semi(nBlocks, -1);   // semidominator, as a DFS number
+  std::vector<int> vertex;              // block with a given DFS number
+  std::vector<int> parent(nBlocks, -1); // parent in the DFS spanning tree
+  std::vector<int> ancestor(nBlocks, -1);
+  std::vector<int> label(nBlocks);
+  std::vector<std::vector<int> > bucket(nBlocks);
+
+  //
+  // Number the blocks reachable from the entry block in depth-first order
+  //
+  std::vector<std::pair<int, size_t> > stack;
+
+  semi[0] = 0;
+  vertex.push_back(0);
+  stack.push_back(std::make_pair(0, (size_t) 0));
+
+  while (stack.size() > 0) {
+    int         v    = stack.back().first;
+    size_t&     next = stack.back().second;
+    BasicBlock* bb   = basicBlocks[v];
+
+    if (next < bb->outs.size()) {
+      int w = bb->outs[next++]->id;
+
+      if (semi[w] == -1) {
+        semi[w]   = vertex.size();
+        parent[w] = v;
+        vertex.push_back(w);
+        stack.push_back(std::make_pair(w, (size_t) 0));
       }
+    } else {
+      stack.pop_back();
+    }
+  }
+
+  for (int i = 0; i < nBlocks; i++)
+    label[i] = i;
+
+  int nReached = vertex.size();
+
+  //
+  // Compute the semidominators in reverse DFS order, and the immediate
+  // dominators of the blocks whose semidominator is the parent just linked
+  //
+  std::vector<int> path;
+
+  for (int i = nReached - 1; i > 0; i--) {
+    int w = vertex[i];
+
+    for_vector(BasicBlock, in, basicBlocks[w]->ins) {
+      int v = in->id;
+
+      if (semi[v] == -1)
+        continue;
+
+      int u = eval(v, ancestor, label, semi, path);
+
+      if (semi[u] < semi[w])
+        semi[w] = semi[u];
+    }
+
+    bucket[vertex[semi[w]]].push_back(w);
+
+    ancestor[w] = parent[w];
+
+    std::vector<int>& linked = bucket[parent[w]];
+
+    for (size_t j = 0; j < linked.size(); j++) {
+      int v = linked[j];
+      int u = eval(v, ancestor, label, semi, path);
+
+      mIdom[v] = (semi[u] < semi[v]) ? u : parent[w];
     }
+
+    linked.clear();
+  }
+
+  for (int i = 1; i < nReached; i++) {
+    int w = vertex[i];
+
+    if (mIdom[w] != vertex[semi[w]])
+      mIdom[w] = mIdom[mIdom[w]];
   }
 
-  unsetDeadBlocks(dominators, basicBlocks);
+  //
+  // Number the dominator tree in preorder; the blocks dominated by a
+  // block are numbered from its number to mLast of it
+  //
+  std::vector<std::vector<int> > children(nBlocks);
+
+  for (int i = 1; i < nReached; i++)
+    children[mIdom[vertex[i]]].push_back(vertex[i]);
+
+  std::vector<std::pair<int, size_t> > walk;
+  int                                  number = 0;
+
+  mPre[0] = number++;
+  walk.push_back(std::make_pair(0, (size_t) 0));
+
+  while (walk.size() > 0) {
+    int     v    = walk.back().first;
+    size_t& next = walk.back().second;
+
+    if (next < children[v].size()) {
+      int w = children[v][next++];
+
+      mPre[w] = number++;
+      walk.push_back(std::make_pair(w, (size_t) 0));
+    } else {
+      mLast[v] = number - 1;
+      walk.pop_back();
+    }
+  }
 }
 
 
 /* 
- * Checks if a node a dominates node b in the set of dominators 
+ * Checks if a node a dominates node b
  *
  * A node a dominates node b if every path path from the entry node 
  * to node b must go through a.
  */
-bool dominates(unsigned a, unsigned b, std::vector<BitVec*> & dominators) {
-  if(dominators[b]->test(a)) {
-   return true;
-  } 
-  return false;
+bool DominatorTree::dominates(unsigned a, unsigned b) const {
+  if (mPre[a] == -1 || mPre[b] == -1)
+    return false;
+
+  return mPre[a] <= mPre[b] && mPre[b] <= mLast[a];
 }
 
 
 /*
- * Checks if a node a strictly dominates node b in the set of dominators 
+ * Checks if a node a strictly dominates node b
  * 
  * A node a strictly dominates node b if a dominates b and a!= b
  */
-bool strictlyDominates(unsigned a, unsigned b, std::vector<BitVec*> & dominators) {
- if(a == b) {
-   return false;
- }
- return dominates(a, b, dominators);
+bool DominatorTree::strictlyDominates(unsigned a, unsigned b) const {
+  if (a == b)
+    return false;
+
+  return dominates(a, b);
 }
 
 
 /*
- * Computes the immediate dominators from the dominators 
- * 
- * This algorithm is based on the immediate dominator computation found in Advanced Compiler 
- * Design Implementation. It takes the already computed dominator set and set the immediate
- * dominators. For instance to get the immediate dominator of i simply get 
- * immediate Dominators[i]
- *
  * A node a immediately dominates node b if and only if a strictly dominates b
  * and there does not exist a node c such that a strictly dominates c and c 
  * strictly dominates b
  */
-void computeImmediateDominators(std::vector<unsigned>& immediateDominators, std::vector<BitVec*>& dominators) {
-  unsigned nBlocks = dominators.size();
-  
-  //Create a temporary dominator set
-  std::vector<BitVec*> temp;
-  for(unsigned i = 0; i < nBlocks; i++) {
-    temp.push_back(new BitVec(nBlocks));
-  }
-  
-  //Set temp[i] to the dominators[i] - {i} (the strict dominators) 
-  for(unsigned i = 0; i < nBlocks; i++) {
-    for(unsigned j = 0; j < nBlocks; j++) {
-      if(strictlyDominates(i, j, dominators)) {
-        temp[j]->set(i);
-      }
-    }
-  }
- 
-  //For each node i check whether each node that dominates i
-  //has dominators other than itself and if so remove them.
-  //This leaves each non-root node having a single dominator
-  for(unsigned i = 1; i < nBlocks; i++) {
-    for(unsigned j = 0; j < nBlocks; j++){
-      for(unsigned k = 0; k < nBlocks; k++) {
-        if(strictlyDominates(k, i, temp) && strictlyDominates(j, i, temp)) {
-          if(strictlyDominates(k, j, temp)) {
-            temp[i]->reset(k);
-          }
-        }        
-      }
-    }
-  }
-
-  //Extract the node that is the immediate dominator 
-  //and store it in immediateDominators
-  for(unsigned i = 1; i < nBlocks; i++) {
-    for(unsigned j = 0; j < nBlocks; j++) {
-      if(strictlyDominates(j, i, temp)) {
-        immediateDominators[i] = j;
-      }
-    }
-  }
+int DominatorTree::immediateDominator(unsigned b) const {
+  return mIdom[b];
 }
-
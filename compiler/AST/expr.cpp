@@ -428,7 +428,7 @@ SymExpr::SymExpr(Symbol* init_var) :
 {
   if (!init_var)
     INT_FATAL(this, "Bad call to SymExpr");
-  gSymExprs.add(this);
+  registerAst(gSymExprs, this);
 }
 
 bool SymExpr::isNoInitExpr() const {
@@ -537,7 +537,7 @@ UnresolvedSymExpr::UnresolvedSymExpr(const char* i_unresolved) :
 {
   if (!i_unresolved)
     INT_FATAL(this, "bad call to UnresolvedSymExpr");
-  gUnresolvedSymExprs.add(this);
+  registerAst(gUnresolvedSymExprs, this);
 }
 
 void
@@ -625,7 +625,7 @@ DefExpr::DefExpr(Symbol* initSym, BaseAST* initInit, BaseAST* initExprType) :
   if (isArgSymbol(sym) && (exprType || init))
     INT_FATAL(this, "DefExpr of ArgSymbol cannot have either exprType or init");
 
-  gDefExprs.add(this);
+  registerAst(gDefExprs, this);
 }
 
 Expr* DefExpr::getFirstExpr() {
@@ -3459,7 +3459,7 @@ CallExpr::CallExpr(BaseAST* base, BaseAST* arg1, BaseAST* arg2,
   callExprHelper(this, arg3);
   callExprHelper(this, arg4);
   argList.parent = this;
-  gCallExprs.add(this);
+  registerAst(gCallExprs, this);
 }
 
 
@@ -3478,7 +3478,7 @@ CallExpr::CallExpr(PrimitiveOp *prim, BaseAST* arg1, BaseAST* arg2,
   callExprHelper(this, arg3);
   callExprHelper(this, arg4);
   argList.parent = this;
-  gCallExprs.add(this);
+  registerAst(gCallExprs, this);
 }
 
 CallExpr::CallExpr(PrimitiveTag prim, BaseAST* arg1, BaseAST* arg2,
@@ -3496,7 +3496,7 @@ CallExpr::CallExpr(PrimitiveTag prim, BaseAST* arg1, BaseAST* arg2,
   callExprHelper(this, arg3);
   callExprHelper(this, arg4);
   argList.parent = this;
-  gCallExprs.add(this);
+  registerAst(gCallExprs, this);
 }
 
 
@@ -3515,7 +3515,7 @@ CallExpr::CallExpr(const char* name, BaseAST* arg1, BaseAST* arg2,
   callExprHelper(this, arg3);
   callExprHelper(this, arg4);
   argList.parent = this;
-  gCallExprs.add(this);
+  registerAst(gCallExprs, this);
 }
 
 
@@ -5234,6 +5234,17 @@ GenRet CallExpr::codegen() {
       ret = size;
       break;
     }
+    case PRIM_STACK_ALLOCATE_CLASS:
+    {
+      AggregateType* ct = toAggregateType(get(1)->typeInfo());
+      INT_ASSERT(ct && ct->isClass());
+
+      // The instance is a local of the enclosing function, so it lives
+      // until the function returns.
+      GenRet tmp = createTempVar(ct->classStructName(true));
+      ret = codegenCast(ct, codegenAddrOf(tmp));
+      break;
+    }
     case PRIM_CAST: 
     {
       if (typeInfo()->symbol->hasFlag(FLAG_WIDE_CLASS) ||
@@ -5727,7 +5738,7 @@ NamedExpr::NamedExpr(const char* init_name, Expr* init_actual) :
   name(init_name),
   actual(init_actual)
 {
-  gNamedExprs.add(this);
+  registerAst(gNamedExprs, this);
 }
 
 
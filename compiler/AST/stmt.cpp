@@ -97,7 +97,7 @@ BlockStmt::BlockStmt(Expr* initBody, BlockTag initBlockTag) :
   if (initBody)
     body.insertAtTail(initBody);
 
-  gBlockStmts.add(this);
+  registerAst(gBlockStmts, this);
 }
 
 
@@ -533,7 +533,7 @@ CondStmt::CondStmt(Expr* iCondExpr, BaseAST* iThenStmt, BaseAST* iElseStmt) :
     }
   }
 
-  gCondStmts.add(this);
+  registerAst(gCondStmts, this);
 }
 
 Expr*
@@ -778,7 +778,7 @@ GotoStmt::GotoStmt(GotoTag init_gotoTag, const char* init_label) :
   label(init_label ? (Expr*)new UnresolvedSymExpr(init_label)
                    : (Expr*)new SymExpr(gNil))
 {
-  gGotoStmts.add(this);
+  registerAst(gGotoStmts, this);
 }
 
 
@@ -787,7 +787,7 @@ GotoStmt::GotoStmt(GotoTag init_gotoTag, Symbol* init_label) :
   gotoTag(init_gotoTag),
   label(new SymExpr(init_label))
 {
-  gGotoStmts.add(this);
+  registerAst(gGotoStmts, this);
 }
 
 
@@ -802,7 +802,7 @@ GotoStmt::GotoStmt(GotoTag init_gotoTag, Expr* init_label) :
   if (init_label->parentSymbol)
     INT_FATAL(this, "GotoStmt initialized with label already in tree");
 
-  gGotoStmts.add(this);
+  registerAst(gGotoStmts, this);
 }
 
 
@@ -987,7 +987,7 @@ ExternBlockStmt::ExternBlockStmt(const char* init_c_code) :
   Stmt(E_ExternBlockStmt),
   c_code(init_c_code)
 {
-  gExternBlockStmts.add(this);
+  registerAst(gExternBlockStmts, this);
 }
 
 void ExternBlockStmt::verify() {
@@ -261,7 +261,7 @@ VarSymbol::VarSymbol(const char *init_name,
   doc(NULL),
   isField(false)
 {
-  gVarSymbols.add(this);
+  registerAst(gVarSymbols, this);
 }
 
 
@@ -789,7 +789,18 @@ void VarSymbol::codegenDefC(bool global) {
   //
   bool isStatic =  global && !hasFlag(FLAG_EXPORT) && !hasFlag(FLAG_EXTERN);
 
-  std::string str = (isStatic ? "static " : "") + typestr + " " + cname;
+  //
+  // with --incremental, CHPL_GEN_GLOBAL makes the header's global variables
+  // definitions in _main.c and extern declarations in the module files.
+  //
+  const char* storage = "";
+
+  if (global && fIncrementalCompilation)
+    storage = "CHPL_GEN_GLOBAL ";
+  else if (isStatic)
+    storage = "static ";
+
+  std::string str = storage + typestr + " " + cname;
   if (ct) {
     if (ct->isClass()) {
       if (isFnSymbol(defPoint->parentSymbol)) {
@@ -988,7 +999,7 @@ ArgSymbol::ArgSymbol(IntentTag iIntent, const char* iName,
     variableExpr = block;
   else
     variableExpr = new BlockStmt(iVariableExpr, BLOCK_SCOPELESS);
-  gArgSymbols.add(this);
+  registerAst(gArgSymbols, this);
 }
 
 
@@ -1220,7 +1231,7 @@ TypeSymbol::TypeSymbol(const char* init_name, Type* init_type) :
   if (!type)
     INT_FATAL(this, "TypeSymbol constructor called without type");
   type->addSymbol(this);
-  gTypeSymbols.add(this);
+  registerAst(gTypeSymbols, this);
 }
 
 
@@ -1473,7 +1484,7 @@ FnSymbol::FnSymbol(const char* initName) :
   retSymbol(NULL)
 {
   substitutions.clear();
-  gFnSymbols.add(this);
+  registerAst(gFnSymbols, this);
   formals.parent = this;
 }
 
@@ -1881,9 +1892,10 @@ void FnSymbol::codegenHeaderC(void) {
 
   //
   // A function prototype can be labeled static if it is neither
-  // exported nor external
+  // exported nor external, and the modules are not compiled separately
   //
-  if (!hasFlag(FLAG_EXPORT) && !hasFlag(FLAG_EXTERN)) {
+  if (!hasFlag(FLAG_EXPORT) && !hasFlag(FLAG_EXTERN) &&
+      !fIncrementalCompilation) {
     fprintf(outfile, "static ");
   }
   fprintf(outfile, "%s", codegenFunctionType(true).c.c_str());
@@ -2466,7 +2478,7 @@ void FnSymbol::printDocs(std::ostream *file, unsigned int tabs) {
 EnumSymbol::EnumSymbol(const char* init_name) :
   Symbol(E_EnumSymbol, init_name)
 {
-  gEnumSymbols.add(this);
+  registerAst(gEnumSymbols, this);
 }
 
 
@@ -2526,7 +2538,7 @@ ModuleSymbol::ModuleSymbol(const char* iName,
 
   block->parentSymbol = this;
   registerModule(this);
-  gModuleSymbols.add(this);
+  registerAst(gModuleSymbols, this);
 }
 
 
@@ -2932,7 +2944,7 @@ LabelSymbol::LabelSymbol(const char* init_name) :
   Symbol(E_LabelSymbol, init_name, NULL),
   iterResumeGoto(NULL)
 {
-  gLabelSymbols.add(this);
+  registerAst(gLabelSymbols, this);
 }
 
 
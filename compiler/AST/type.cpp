@@ -108,7 +108,7 @@ PrimitiveType::PrimitiveType(Symbol *init, bool internalType) :
   Type(E_PrimitiveType, init)
 {
   isInternalType = internalType;
-  gPrimitiveTypes.add(this);
+  registerAst(gPrimitiveTypes, this);
 }
 
 
@@ -191,7 +191,7 @@ EnumType::EnumType() :
   constants(), integerType(NULL),
   doc(NULL)
 {
-  gEnumTypes.add(this);
+  registerAst(gEnumTypes, this);
   constants.parent = this;
 }
 
@@ -585,7 +585,7 @@ AggregateType::AggregateType(AggregateTag initTag) :
   methods.clear();
   fields.parent = this;
   inherits.parent = this;
-  gAggregateTypes.add(this);
+  registerAst(gAggregateTypes, this);
 }
 
 
@@ -21,24 +21,33 @@
 #include "bitVec.h"
 
 #define TYPE unsigned
-
-BitVec::BitVec(size_t in_size) {
-  if (in_size == 0) {
+#define BITS (sizeof(TYPE)<<3)
+
+BitVec::BitVec(size_t in_size, bool sparse) {
+  this->in_size = in_size;
+  this->sparse = sparse;
+  index = NULL;
+  capacity = 0;
+  if (in_size == 0 || sparse) {
     ndata = 0;
-    this->in_size = 0;
     data = NULL;
   } else {
-    ndata = 1 + (in_size-1) / (sizeof(TYPE)<<3);
-    this->in_size = in_size;
+    ndata = 1 + (in_size-1) / BITS;
     data = (TYPE*)calloc(ndata, sizeof(TYPE));
   }
 }
 
 
 BitVec::BitVec(const BitVec& rhs)
-: data(NULL), in_size(rhs.in_size), ndata(rhs.ndata)
+: data(NULL), index(NULL), in_size(rhs.in_size), ndata(rhs.ndata),
+  capacity(0), sparse(rhs.sparse)
 {
-  if (ndata > 0)
+  if (sparse)
+  {
+    ndata = 0;
+    copy(rhs);
+  }
+  else if (ndata > 0)
   {
     data = (TYPE*)calloc(ndata, sizeof(TYPE));
     copy(rhs);
@@ -48,10 +57,126 @@ BitVec::BitVec(const BitVec& rhs)
 
 BitVec::~BitVec() {
   free(data);
+  free(index);
+}
+
+
+//
+// the number of words needed to hold in_size bits
+//
+size_t BitVec::words() const {
+  return (in_size + BITS - 1) / BITS;
+}
+
+
+//
+// the position in a sparse BitVec of word j, or of the first word after
+// it if word j is not stored
+//
+size_t BitVec::find(size_t j) const {
+  size_t lo = 0;
+  size_t hi = ndata;
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (index[mid] < j)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+
+TYPE BitVec::word(size_t j) const {
+  if (!sparse)
+    return data[j];
+  size_t k = find(j);
+  return (k < ndata && index[k] == j) ? data[k] : 0;
+}
+
+
+//
+// the storage for word j, adding it to a sparse BitVec if necessary
+//
+TYPE* BitVec::wordRef(size_t j) {
+  if (sparse) {
+    size_t k = find(j);
+    if (k < ndata && index[k] == j)
+      return &data[k];
+    if (2 * (ndata + 1) < words()) {
+      reserve(ndata + 1);
+      memmove(&data[k+1], &data[k], (ndata - k) * sizeof(TYPE));
+      memmove(&index[k+1], &index[k], (ndata - k) * sizeof(TYPE));
+      data[k] = 0;
+      index[k] = j;
+      ndata++;
+      return &data[k];
+    }
+    makeDense();
+  }
+  return &data[j];
+}
+
+
+//
+// switch a sparse BitVec to the dense representation
+//
+void BitVec::makeDense() {
+  if (!sparse)
+    return;
+  size_t n = words();
+  TYPE* dense = (n > 0) ? (TYPE*)calloc(n, sizeof(TYPE)) : NULL;
+  for (size_t k = 0; k < ndata; k++)
+    dense[index[k]] = data[k];
+  free(data);
+  free(index);
+  data = dense;
+  index = NULL;
+  ndata = n;
+  capacity = 0;
+  sparse = false;
+}
+
+
+//
+// make room for n words in a sparse BitVec
+//
+void BitVec::reserve(size_t n) {
+  if (n <= capacity)
+    return;
+  size_t newCapacity = (capacity > 0) ? 2 * capacity : 4;
+  while (newCapacity < n)
+    newCapacity *= 2;
+  data = (TYPE*)realloc(data, newCapacity * sizeof(TYPE));
+  index = (TYPE*)realloc(index, newCapacity * sizeof(TYPE));
+  capacity = newCapacity;
+}
+
+
+//
+// drop the zero words from a sparse BitVec
+//
+void BitVec::compact() {
+  size_t n = 0;
+  for (size_t k = 0; k < ndata; k++) {
+    if (data[k]) {
+      data[n] = data[k];
+      index[n] = index[k];
+      n++;
+    }
+  }
+  ndata = n;
+}
+
+
+bool BitVec::preferSparse(size_t in_size, size_t expected) {
+  return in_size >= 1024 && expected * 16 < in_size;
 }
 
 
 void BitVec::clear() {
+  if (sparse)
+    ndata = 0;
   for (size_t i = 0; i < ndata; i++)
     data[i] = 0;
 }
@@ -62,16 +187,14 @@ bool BitVec::get(size_t i) const {
   if (i >= in_size) 
     INT_FATAL("BitVec::get -- operand out of range.");
 #endif
-  size_t j = i / (sizeof(TYPE)<<3);
-  size_t k = i - j*(sizeof(TYPE)<<3);
-  return data[j] & (1 << k);
+  size_t j = i / BITS;
+  size_t k = i - j*BITS;
+  return word(j) & (1 << k);
 }
 
 
 void BitVec::unset(size_t i) {
-  size_t j = i / (sizeof(TYPE)<<3);
-  size_t k = i - j*(sizeof(TYPE)<<3);
-  data[j] &= ((TYPE)-1) - (1 << k);
+  reset(i);
 }
 
 
@@ -80,8 +203,49 @@ void BitVec::disjunction(const BitVec& other) {
   if (other.in_size != in_size)
     INT_FATAL("BitVec::disjunction -- operand lengths must be equal.");
 #endif
-  for (size_t i = 0; i < ndata; i++)
-    data[i] |= other.data[i];
+  if (sparse && !other.sparse)
+    makeDense();
+  if (!other.sparse) {
+    for (size_t i = 0; i < ndata; i++)
+      data[i] |= other.data[i];
+  } else if (!sparse) {
+    for (size_t k = 0; k < other.ndata; k++)
+      data[other.index[k]] |= other.data[k];
+  } else if (other.ndata > 0) {
+    // merge the two sorted word lists from the back, in place
+    size_t n = 0;
+    for (size_t k = 0, l = 0; k < ndata || l < other.ndata; n++) {
+      if (l == other.ndata || (k < ndata && index[k] < other.index[l]))
+        k++;
+      else if (k == ndata || other.index[l] < index[k])
+        l++;
+      else
+        k++, l++;
+    }
+    if (2 * n >= words()) {
+      makeDense();
+      disjunction(other);
+      return;
+    }
+    reserve(n);
+    size_t k = ndata, l = other.ndata;
+    for (size_t m = n; m > 0; m--) {
+      if (l == 0 || (k > 0 && index[k-1] > other.index[l-1])) {
+        k--;
+        data[m-1] = data[k];
+        index[m-1] = index[k];
+      } else if (k == 0 || other.index[l-1] > index[k-1]) {
+        l--;
+        data[m-1] = other.data[l];
+        index[m-1] = other.index[l];
+      } else {
+        k--, l--;
+        data[m-1] = data[k] | other.data[l];
+        index[m-1] = index[k];
+      }
+    }
+    ndata = n;
+  }
 }
 
 
@@ -90,8 +254,94 @@ void BitVec::intersection(const BitVec& other) {
   if (other.in_size != in_size)
     INT_FATAL("BitVec::intersection -- operand lengths must be equal.");
 #endif
-  for (size_t i = 0; i < ndata; i++)
-    data[i] &= other.data[i];
+  if (!sparse && !other.sparse) {
+    for (size_t i = 0; i < ndata; i++)
+      data[i] &= other.data[i];
+  } else if (!sparse) {
+    size_t l = 0;
+    for (size_t i = 0; i < ndata; i++) {
+      if (l < other.ndata && other.index[l] == i)
+        data[i] &= other.data[l++];
+      else
+        data[i] = 0;
+    }
+  } else if (!other.sparse) {
+    for (size_t k = 0; k < ndata; k++)
+      data[k] &= other.data[index[k]];
+    compact();
+  } else {
+    size_t n = 0;
+    for (size_t k = 0, l = 0; k < ndata && l < other.ndata; ) {
+      if (index[k] < other.index[l])
+        k++;
+      else if (other.index[l] < index[k])
+        l++;
+      else {
+        if (TYPE w = data[k] & other.data[l]) {
+          data[n] = w;
+          index[n] = index[k];
+          n++;
+        }
+        k++, l++;
+      }
+    }
+    ndata = n;
+  }
+}
+
+
+void BitVec::difference(const BitVec& other) {
+#if DEBUG
+  if (other.in_size != in_size)
+    INT_FATAL("BitVec::difference -- operand lengths must be equal.");
+#endif
+  if (!sparse && !other.sparse) {
+    for (size_t i = 0; i < ndata; i++)
+      data[i] &= ~other.data[i];
+  } else if (!sparse) {
+    for (size_t l = 0; l < other.ndata; l++)
+      data[other.index[l]] &= ~other.data[l];
+  } else if (!other.sparse) {
+    for (size_t k = 0; k < ndata; k++)
+      data[k] &= ~other.data[index[k]];
+    compact();
+  } else {
+    for (size_t k = 0, l = 0; k < ndata && l < other.ndata; ) {
+      if (index[k] < other.index[l])
+        k++;
+      else if (other.index[l] < index[k])
+        l++;
+      else
+        data[k++] &= ~other.data[l++];
+    }
+    compact();
+  }
+}
+
+
+bool BitVec::transfer(const BitVec& in, const BitVec& kill, const BitVec& gen) {
+#if DEBUG
+  if (in.in_size != in_size || kill.in_size != in_size || gen.in_size != in_size)
+    INT_FATAL("BitVec::transfer -- operand lengths must be equal.");
+#endif
+  if (!sparse && !in.sparse && !kill.sparse && !gen.sparse) {
+    bool change = false;
+    for (size_t i = 0; i < ndata; i++) {
+      TYPE w = (in.data[i] & ~kill.data[i]) | gen.data[i];
+      if (w != data[i]) {
+        data[i] = w;
+        change = true;
+      }
+    }
+    return change;
+  }
+  BitVec result(in);
+  result.difference(kill);
+  result.disjunction(gen);
+  if (equals(result))
+    return false;
+  copy(result);
+  return true;
 }
 
 
@@ -110,9 +360,33 @@ bool BitVec::equals(const BitVec& other) const {
   if (other.in_size != in_size)
     INT_FATAL("BitVec::disjunction -- operand lengths must be equal.");
 #endif
-  for(size_t i = 0; i < ndata; i++) {
-    if(data[i] != other.data[i]) {
-      return false;
+  if (!sparse && !other.sparse) {
+    for(size_t i = 0; i < ndata; i++) {
+      if(data[i] != other.data[i]) {
+        return false;
+      }
+    }
+  } else if (!sparse || !other.sparse) {
+    const BitVec& d = (sparse) ? other : *this;
+    const BitVec& s = (sparse) ? *this : other;
+    size_t l = 0;
+    for (size_t i = 0; i < d.ndata; i++) {
+      TYPE w = (l < s.ndata && s.index[l] == i) ? s.data[l++] : 0;
+      if (d.data[i] != w)
+        return false;
+    }
+  } else {
+    size_t k = 0, l = 0;
+    while (k < ndata || l < other.ndata) {
+      if (l == other.ndata || (k < ndata && index[k] < other.index[l])) {
+        if (data[k++])
+          return false;
+      } else if (k == ndata || other.index[l] < index[k]) {
+        if (other.data[l++])
+          return false;
+      } else if (data[k++] != other.data[l++]) {
+        return false;
+      }
     }
   }
   return true;
@@ -120,56 +394,98 @@ bool BitVec::equals(const BitVec& other) const {
 
 
 void BitVec::set() {
+  makeDense();
   for (size_t i = 0; i < ndata; i++)
     data[i] = ~0;
 }
 
 
 void BitVec::set(size_t i) {
-  size_t j = i / (sizeof(TYPE)<<3);
-  size_t k = i - j*(sizeof(TYPE)<<3);
-  data[j] |= 1 << k;
+  size_t j = i / BITS;
+  size_t k = i - j*BITS;
+  *wordRef(j) |= 1 << k;
 }
 
 
 void BitVec::reset() {
-  for (size_t i = 0; i < ndata; i++)
-    data[i] = 0;
+  clear();
 }
       
         
 void BitVec::reset(size_t i) {
-  size_t j = i / (sizeof(TYPE)<<3);
-  size_t k = i - j*(sizeof(TYPE)<<3);
-  data[j] &= ((size_t)-1) - (1 << k);
+  size_t j = i / BITS;
+  size_t k = i - j*BITS;
+  if (sparse) {
+    size_t l = find(j);
+    if (l < ndata && index[l] == j)
+      data[l] &= ~(1 << k);
+  } else {
+    data[j] &= ~(1 << k);
+  }
 }
 
 
+//
+// copy the bits of other, keeping the representation of this unless it
+// is sparse and other is too dense for that
+//
 void BitVec::copy(const BitVec& other) {
-  for (size_t i = 0; i < ndata; ++i)
-    data[i] = other.data[i];
+  if (!sparse) {
+    if (!other.sparse) {
+      for (size_t i = 0; i < ndata; ++i)
+        data[i] = other.data[i];
+    } else {
+      clear();
+      for (size_t l = 0; l < other.ndata; l++)
+        data[other.index[l]] = other.data[l];
+    }
+  } else if (other.sparse) {
+    reserve(other.ndata);
+    memcpy(data, other.data, other.ndata * sizeof(TYPE));
+    memcpy(index, other.index, other.ndata * sizeof(TYPE));
+    ndata = other.ndata;
+  } else {
+    size_t n = 0;
+    for (size_t i = 0; i < other.ndata; i++)
+      if (other.data[i])
+        n++;
+    if (2 * n >= words()) {
+      makeDense();
+      copy(other);
+      return;
+    }
+    reserve(n);
+    ndata = 0;
+    for (size_t i = 0; i < other.ndata; i++) {
+      if (other.data[i]) {
+        data[ndata] = other.data[i];
+        index[ndata] = i;
+        ndata++;
+      }
+    }
+  }
 }
 
 
 void BitVec::copy(size_t i, bool value) {
-  size_t j = i / (sizeof(TYPE)<<3);
-  size_t k = i - j*(sizeof(TYPE)<<3);
-  data[j] &= ~(1 << k);
   if (value)
-    data[j] |= (1 << k);
+    set(i);
+  else
+    reset(i);
 }
 
 
 void BitVec::flip() {
+  makeDense();
   for (size_t i = 0; i < ndata; i++)
     data[i] = ~data[i];
 }
 
 
 void BitVec::flip(size_t i) {
-  size_t j = i / (sizeof(TYPE)<<3);
-  size_t k = i - j*(sizeof(TYPE)<<3);
-  data[j] ^= 1 << k;
+  size_t j = i / BITS;
+  size_t k = i - j*BITS;
+  *wordRef(j) ^= 1 << k;
 }
 
 
@@ -200,9 +516,7 @@ size_t BitVec::size() const {
 
 
 bool BitVec::test(size_t i) const {
-  size_t j = i / (sizeof(TYPE)<<3);
-  size_t k = i - j*(sizeof(TYPE)<<3);
-  return data[j] & (1 << k);
+  return get(i);
 }
 
 
@@ -103,6 +103,27 @@ foreach_ast(proto_classes);
 foreach_ast(decl_gvecs);
 #undef decl_gvecs
 
+//
+// Constructors add their node to the matching global vector through
+// registerAst.  While forEachFunction() is running a pass on several
+// threads the update is serialized.
+//
+extern bool astRegistryShared;
+
+void lockAstRegistry();
+void unlockAstRegistry();
+
+template <class T>
+static inline void registerAst(Vec<T*>& gvec, T* ast) {
+  if (astRegistryShared) {
+    lockAstRegistry();
+    gvec.add(ast);
+    unlockAstRegistry();
+  } else {
+    gvec.add(ast);
+  }
+}
+
 //
 // type definitions for common maps
 //
@@ -157,6 +178,23 @@ static inline bool isSymbol(AstTag tag)
 static inline bool isType(AstTag tag)
 { return tag >= E_PrimitiveType  && tag <= E_AggregateType; }
 
+#define AST_TAG_COUNT (E_AggregateType + 1)
+
+const char* astTagName(AstTag tag);
+
+//
+// The number of nodes of each kind constructed and destroyed since the
+// compiler started.  'bytes' is filled in by getAstKindCounts() as the
+// constructed count times the size of the kind's class.
+//
+struct AstKindCounts {
+  long created;
+  long destroyed;
+  long bytes;
+};
+
+void getAstKindCounts(AstKindCounts counts[AST_TAG_COUNT]);
+
 
 //
 // macros used to define the copy method on all AST node types, and to
@@ -232,6 +270,10 @@ public:
 
   static  const       std::string tabText;
 
+  // AST nodes are allocated from size-class pools (see baseAST.cpp)
+  static void*        operator new(size_t size);
+  static void         operator delete(void* ptr, size_t size);
+
 protected:
                     BaseAST(AstTag type);
   virtual          ~BaseAST();
@@ -266,7 +308,14 @@ void   trace_remove(BaseAST* ast, char flag);
 //
 #define SET_LINENO(ast) astlocMarker markAstLoc(ast->astloc)
 
-extern astlocT currentAstLoc;
+//
+// Each thread that builds AST nodes has its own current location, so that
+// SET_LINENO can be used from the per-function pass workers started by
+// forEachFunction() (see parallelPasses.h).
+//
+extern __thread astlocT* currentAstLocPtr;
+
+#define currentAstLoc (*currentAstLocPtr)
 
 class astlocMarker {
 public:
@@ -500,10 +549,23 @@ static inline const LcnSymbol* toConstLcnSymbol(const BaseAST* a)
 //
 // clean IR between passes by clearing some back pointers to dead AST
 // nodes and removing dead AST nodes from the global vectors of AST
-// nodes. "dead" means !isAlive && !isRootModule.
+// nodes. "dead" means !isAlive && !isRootModule.  Only the global
+// vectors of node kinds that had nodes removed from the tree since the
+// last clean are rescanned, plus the nodes created since then.
 //
 void cleanAst(void);
 
+//
+// record a node taken out of the tree (called by remove_help)
+//
+void noteRemovedAst(BaseAST* ast);
+
+//
+// the number of nodes the last cleanAst examined and the number of
+// nodes in the vectors it did not need to rescan
+//
+void cleanAstStatistics(int& examined, int& skipped);
+
 //
 // reclaim memory associated with all AST nodes (called at the end)
 //
@@ -81,13 +81,15 @@ public:
 
   static void               printBitVectorSets(BitVecVector& sets);
 
-  static BasicBlock*        basicBlock;
+  // The builder state is per-thread so that functions can be processed
+  // concurrently by forEachFunction().
+  static __thread BasicBlock* basicBlock;
 
-  static Map<LabelSymbol*,
-             BasicBlock*>   labelMaps;
+  static __thread Map<LabelSymbol*,
+                      BasicBlock*>* labelMaps;
 
-  static Map<LabelSymbol*,
-             BasicBlockVector*> gotoMaps;
+  static __thread Map<LabelSymbol*,
+                      BasicBlockVector*>* gotoMaps;
 
 private:
   static void               buildBasicBlocks(FnSymbol* fn,
@@ -104,7 +106,7 @@ private:
   static void               removeEmptyBlocks(FnSymbol* fn);
   static bool               verifyBasicBlocks(FnSymbol* fn);
 
-  static int                nextID;
+  static __thread int       nextID;
 
   //
   // Instance methods/variables
@@ -20,13 +20,25 @@
 #ifndef _CHPL_BIT_VEC_H_
 #define _CHPL_BIT_VEC_H_
 
+//
+// A BitVec is kept in one of two representations.  A dense BitVec
+// stores every word of the set in data.  A sparse BitVec stores only
+// the words that have been touched: data holds ndata words and index
+// holds the word number of each of them, in increasing order.  A
+// sparse BitVec switches itself to the dense representation once it
+// stops saving memory, so sparse is a safe choice for any set that is
+// expected to hold few bits.
+//
 class BitVec {
  public:
   unsigned* data;
+  unsigned* index;      // NULL unless sparse
   size_t in_size;
-  size_t ndata;
+  size_t ndata;         // number of words in data
+  size_t capacity;      // number of words allocated for a sparse BitVec
+  bool sparse;
 
-  BitVec(size_t in_size);
+  BitVec(size_t in_size, bool sparse = false);
   BitVec(const BitVec& rhs);
   ~BitVec();
   void clear();
@@ -35,6 +47,14 @@ class BitVec {
   void unset(size_t i);
   void disjunction(const BitVec& other);
   void intersection(const BitVec& other);
+  void difference(const BitVec& other);
+
+  // this = (in - kill) + gen, returning true if this changed
+  bool transfer(const BitVec& in, const BitVec& kill, const BitVec& gen);
+
+  // Whether a set of in_size bits that is expected to hold about
+  // expected bits should be sparse
+  static bool preferSparse(size_t in_size, size_t expected);
   
   
   // Added functionality to make this compatible with std::bitset and thus 
@@ -53,6 +73,17 @@ class BitVec {
   bool test(size_t i) const;
   bool any() const;
   bool none() const;
+
+ private:
+  BitVec& operator=(const BitVec& rhs);
+
+  size_t words() const;
+  size_t find(size_t j) const;
+  unsigned word(size_t j) const;
+  unsigned* wordRef(size_t j);
+  void makeDense();
+  void reserve(size_t n);
+  void compact();
 };
 
 inline BitVec operator+(const BitVec& a, const BitVec& b)
@@ -64,9 +95,8 @@ inline BitVec operator+(const BitVec& a, const BitVec& b)
 
 inline BitVec operator-(const BitVec& a, const BitVec& b)
 {
-  BitVec result(b);
-  result.flip();
-  result.intersection(a);
+  BitVec result(a);
+  result.difference(b);
   return result;
 }
 
@@ -22,13 +22,33 @@
 
 #include "astutil.h"
 #include "bb.h"
-#include "bitVec.h"
-#include <set>
 
-void computeDominators(std::vector<BitVec*>& dominators, std::vector<BasicBlock*>& basicBlocks);
-bool dominates(unsigned a, unsigned b, std::vector<BitVec*> & dominators);
-bool strictlyDominates(unsigned a, unsigned b, std::vector<BitVec*> & dominators);
+#include <vector>
 
-void computeImmediateDominators(std::vector<unsigned>& immediateDominators, std::vector<BitVec*>& dominators);
+/*
+ * The dominator tree of the basic blocks of a function, with block 0 as
+ * the entry block.  It is built with the Lengauer-Tarjan algorithm and
+ * numbers the tree in depth-first order, so that a dominates b exactly
+ * when the interval of b's number falls within the interval of a's
+ * subtree.
+ *
+ * Blocks that cannot be reached from the entry block do not dominate
+ * and are not dominated by any block, including themselves.
+ */
+class DominatorTree {
+public:
+                      DominatorTree(std::vector<BasicBlock*>& basicBlocks);
+
+  bool                dominates(unsigned a, unsigned b)              const;
+  bool                strictlyDominates(unsigned a, unsigned b)      const;
+
+  // -1 for the entry block and for unreachable blocks
+  int                 immediateDominator(unsigned b)                 const;
+
+private:
+  std::vector<int>    mIdom;
+  std::vector<int>    mPre;      // preorder number, -1 if unreachable
+  std::vector<int>    mLast;     // last preorder number in the subtree
+};
 
 #endif
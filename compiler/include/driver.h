@@ -36,6 +36,7 @@ extern int  fConditionalDynamicDispatchLimit;
 extern bool fNoBoundsChecks;
 extern bool fNoCopyPropagation;
 extern bool fNoDeadCodeElimination;
+extern bool fSparseCopyPropagation;
 extern bool fNoGlobalConstOpt;
 extern bool fNoFastFollowers;
 extern bool fNoInlineIterators;
@@ -47,6 +48,7 @@ extern bool fNoNilChecks;
 extern bool fNoStackChecks;
 extern bool fNoCastChecks;
 extern bool fMungeUserIdents;
+extern bool fIncrementalCompilation;
 extern bool fEnableTaskTracking;
 extern bool fLLVMWideOpt;
 
@@ -60,6 +62,7 @@ extern bool fNoPrivatization;
 extern bool fNoOptimizeOnClauses;
 extern bool fNoRemoveEmptyRecords;
 extern bool fRemoveUnreachableBlocks;
+extern int  inline_threshold;
 extern int  optimize_on_clause_limit;
 extern int  scalar_replace_limit;
 extern int  tuple_copy_limit;
@@ -96,6 +99,7 @@ extern const char* chpl_env_var_names[];
 
 extern bool  printPasses;
 extern FILE* printPassesFile;
+extern char  passesProfileFile[FILENAME_MAX+1];
 
 // Set true if CHPL_WIDE_POINTERS==struct.
 // In that case, the code generator emits structures
@@ -40,7 +40,7 @@ struct fileinfo {
   const char* pathname;
 };
 
-void codegen_makefile(fileinfo* mainfile, const char** tmpbinname=NULL, bool skip_compile_link=false);
+void codegen_makefile(fileinfo* mainfile, const char** tmpbinname=NULL, bool skip_compile_link=false, Vec<const char*>* moduleFiles=NULL);
 
 void ensureDirExists(const char* /* dirname */, const char* /* explanation */);
 const char* getCwd();
@@ -46,6 +46,7 @@ void removeUnnecessaryGotos(FnSymbol* fn);
 void removeUnusedLabels(FnSymbol* fn);
 size_t localCopyPropagation(FnSymbol* fn);
 size_t globalCopyPropagation(FnSymbol* fn);
+size_t sparseCopyPropagation(FnSymbol* fn);
 void eliminateSingleAssignmentReference(Map<Symbol*,Vec<SymExpr*>*>& defMap,
                                         Map<Symbol*,Vec<SymExpr*>*>& useMap,
                                         Symbol* var);
@@ -0,0 +1,46 @@
+/*
+ * Copyright 2004-2015 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _PARALLEL_PASSES_H_
+#define _PARALLEL_PASSES_H_
+
+#include "vec.h"
+
+class FnSymbol;
+
+//
+// The number of threads used to run function-local passes.  Set by the
+// developer flag --pass-threads; 1 (the default) runs everything on the
+// main thread, exactly as before.
+//
+extern int fPassThreads;
+
+//
+// Apply 'fnPass' to every function in 'fns'.
+//
+// With --pass-threads > 1 the functions are handed out to a pool of worker
+// threads, so 'fnPass' must only modify the function it is given.  It may
+// create and remove AST nodes (registration in the global vectors and
+// SET_LINENO are thread-safe while the workers run), but it must not
+// create or rename symbols through astr(), resolve calls, or update any
+// other global tables.
+//
+void forEachFunction(Vec<FnSymbol*>& fns, void (*fnPass)(FnSymbol*));
+
+#endif
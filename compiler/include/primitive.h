@@ -136,6 +136,8 @@ enum PrimitiveTag {
   PRIM_SET_SERIAL,              // set serial state to true or false
 
   PRIM_SIZEOF,
+  PRIM_STACK_ALLOCATE_CLASS,    // allocate a class instance in the caller's
+                                // stack frame
 
   PRIM_INIT_FIELDS,             // initialize fields of a temporary record
   PRIM_PTR_EQUAL,
@@ -21,11 +21,14 @@
 
 #include "baseAST.h"
 #include "driver.h"
+#include "misc.h"
 
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
 
+#include <sys/resource.h>
+
 // Used to collect the times as the program runs
 class Phase
 {
@@ -48,6 +51,11 @@ public:
   int                      mPassId;
   PhaseTracker::SubPhase   mSubPhase;
   unsigned long            mStartTime;  // Elapsed time from main() usecs
+  int                      mCleanExamined; // Only set for kCleanAst
+  int                      mCleanSkipped;  // Only set for kCleanAst
+
+  long                     mMaxRss;     // Peak resident set (KB) at start
+  AstKindCounts            mAstCounts[AST_TAG_COUNT];
 
 private:
   Phase();
@@ -65,6 +73,7 @@ public:
                         unsigned long mainTime,
                         unsigned long checkTime,
                         unsigned long cleanTime,
+                        double        savedTime,
                         unsigned long totalTime);
 
   bool           CompareByTime(Pass const& ref)      const;
@@ -74,7 +83,15 @@ public:
 
   void           Print(FILE*         fp,
                        unsigned long accumTime, 
-                       unsigned long totalTime)      const;
+                       unsigned long totalTime,
+                       double        nodeTime)       const;
+
+  void           SetUsage(const Phase* start, const Phase* end);
+
+  void           PrintJson(FILE* fp, bool last)      const;
+
+  static void    HeaderCsv(FILE* fp);
+  void           PrintCsv(FILE* fp)                  const;
 
   char*          mName;
   int            mPassId;
@@ -82,6 +99,10 @@ public:
   unsigned long  mPrimary;          // usecs()
   unsigned long  mVerify;           // usecs()
   unsigned long  mCleanAst;         // usecs()
+  int            mCleanExamined;    // AST nodes examined by cleanAst
+  int            mCleanSkipped;     // AST nodes cleanAst did not rescan
+  long           mRssDelta;         // Growth in peak resident set (KB)
+  AstKindCounts  mAstCounts[AST_TAG_COUNT]; // Nodes allocated by the pass
 };
 
 struct SortByTime
@@ -101,6 +122,8 @@ static void PassesReport(FILE*                    fp,
                          const std::vector<Pass>& passes,
                          unsigned long            totalTime);
 
+static bool HasSuffix(const char* name, const char* suffix);
+
 /************************************* | **************************************
 *                                                                             *
 * Implementation of PhaseTracker                                              *
@@ -109,7 +132,8 @@ static void PassesReport(FILE*                    fp,
 
 PhaseTracker::PhaseTracker()
 {
-  mPhaseId = 0;
+  mPhaseId   = 0;
+  mStopPhase = 0;
 
   mTimer.start();
   StartPhase("startup");
@@ -119,6 +143,9 @@ PhaseTracker::~PhaseTracker()
 {
   for (size_t i = 0; i < mPhases.size(); i++)
     delete mPhases[i];
+
+  if (mStopPhase)
+    delete mStopPhase;
 }
 
 void PhaseTracker::StartPhase(const char* name)
@@ -148,6 +175,17 @@ void PhaseTracker::StartPhase(const char* name,
 void PhaseTracker::Stop()
 {
   mTimer.stop();
+
+  if (mStopPhase == 0)
+    mStopPhase = new Phase("stop", 0, kPrimary, mTimer.elapsedUsecs());
+}
+
+void PhaseTracker::CleanAstCounts(int examined, int skipped)
+{
+  Phase* phase = mPhases.back();
+
+  phase->mCleanExamined = examined;
+  phase->mCleanSkipped  = skipped;
 }
 
 void PhaseTracker::ReportPass() const
@@ -179,13 +217,51 @@ void PhaseTracker::ReportRollup() const
   PassesReport(passes, totalTime);
 }
 
+void PhaseTracker::ReportProfile(const char* fileName) const
+{
+  std::vector<Pass> passes;
+  unsigned long     totalTime = mTimer.elapsedUsecs();
+  FILE*             fp        = fopen(fileName, "w");
+
+  if (fp == 0)
+  {
+    USR_WARN("Error opening passes profile file: %s.", fileName);
+    return;
+  }
+
+  PassesCollect(passes);
+
+  if (HasSuffix(fileName, ".csv") == true)
+  {
+    Pass::HeaderCsv(fp);
+
+    for (size_t i = 0; i < passes.size(); i++)
+      passes[i].PrintCsv(fp);
+  }
+  else
+  {
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"totalTime\": %.6f,\n", totalTime / 1e6);
+    fprintf(fp, "  \"passes\": [\n");
+
+    for (size_t i = 0; i < passes.size(); i++)
+      passes[i].PrintJson(fp, i == passes.size() - 1);
+
+    fprintf(fp, "  ]\n");
+    fprintf(fp, "}\n");
+  }
+
+  fclose(fp);
+}
+
 void PhaseTracker::PassesCollect(std::vector<Pass>& passes) const
 {
   unsigned long totalTime = mTimer.elapsedUsecs();
 
   if (mPhases.size() > 0)
   {
-    Pass pass;
+    Pass         pass;
+    const Phase* passStart = mPhases[0];
 
     for (size_t i = 0; i < mPhases.size(); i++)
     {
@@ -195,6 +271,9 @@ void PhaseTracker::PassesCollect(std::vector<Pass>& passes) const
       // Check if it's time to push an completed pass
       if (i > 0 && mPhases[i]->mSubPhase == PhaseTracker::kPrimary)
       {
+        pass.SetUsage(passStart, mPhases[i]);
+        passStart = mPhases[i];
+
         passes.push_back(pass);
         pass.Reset();
       }
@@ -218,11 +297,15 @@ void PhaseTracker::PassesCollect(std::vector<Pass>& passes) const
           break;
 
         case PhaseTracker::kCleanAst:
-          pass.mCleanAst = elapsed;
+          pass.mCleanAst      = elapsed;
+          pass.mCleanExamined = mPhases[i]->mCleanExamined;
+          pass.mCleanSkipped  = mPhases[i]->mCleanSkipped;
           break;
       }
     }
 
+    pass.SetUsage(passStart, (mStopPhase != 0) ? mStopPhase : mPhases.back());
+
     passes.push_back(pass);
   }
 }
@@ -251,24 +334,48 @@ static void PassesReport(FILE*                    fp,
   unsigned long mainTime  = 0;
   unsigned long checkTime = 0;
   unsigned long cleanTime = 0;
+  double        savedTime = 0.0;
 
-  Pass::Header(fp);
+  unsigned long examined  = 0;
+  unsigned long skipped   = 0;
+  double        nodeTime  = 0.0;
 
   for (size_t i = 0; i < passes.size(); i++)
   {
-    accumTime = accumTime + passes[i].TotalTime();
+    mainTime  = mainTime  + passes[i].mPrimary;
+    checkTime = checkTime + passes[i].mVerify;
+    cleanTime = cleanTime + passes[i].mCleanAst;
 
-    passes[i].Print(fp, accumTime, totalTime);
+    examined  = examined  + passes[i].mCleanExamined;
+    skipped   = skipped   + passes[i].mCleanSkipped;
   }
 
+  // The time saved by not rescanning nodes is estimated from the average
+  // time cleanAst spent per node it did examine
+  if (examined > 0)
+    nodeTime = (double) cleanTime / examined;
+
+  savedTime = skipped * nodeTime;
+
+  Pass::Header(fp);
+
   for (size_t i = 0; i < passes.size(); i++)
   {
-    mainTime  = mainTime  + passes[i].mPrimary;
-    checkTime = checkTime + passes[i].mVerify;
-    cleanTime = cleanTime + passes[i].mCleanAst;
+    accumTime = accumTime + passes[i].TotalTime();
+
+    passes[i].Print(fp, accumTime, totalTime, nodeTime);
   }
 
-  Pass::Footer(fp, mainTime, checkTime, cleanTime, totalTime);
+  Pass::Footer(fp, mainTime, checkTime, cleanTime, savedTime, totalTime);
+}
+
+static bool HasSuffix(const char* name, const char* suffix)
+{
+  size_t nameLen   = strlen(name);
+  size_t suffixLen = strlen(suffix);
+
+  return nameLen >= suffixLen &&
+         strcmp(name + nameLen - suffixLen, suffix) == 0;
 }
 
 /************************************* | **************************************
@@ -286,6 +393,18 @@ Phase::Phase(const char*            name,
   mPassId    = passId;
   mSubPhase  = subPhase;
   mStartTime = startTime;
+
+  mCleanExamined = 0;
+  mCleanSkipped  = 0;
+
+  struct rusage usage;
+
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+    mMaxRss = usage.ru_maxrss;
+  else
+    mMaxRss = 0;
+
+  getAstKindCounts(mAstCounts);
 }
 
 Phase::~Phase()
@@ -365,6 +484,29 @@ void Pass::Reset()
   mPrimary  = 0;
   mVerify   = 0;
   mCleanAst = 0;
+
+  mCleanExamined = 0;
+  mCleanSkipped  = 0;
+  mRssDelta      = 0;
+
+  memset(mAstCounts, 0, sizeof(mAstCounts));
+}
+
+// The usage of a pass is the difference between the samples taken at the
+// start of the pass and at the start of whatever followed it
+void Pass::SetUsage(const Phase* start, const Phase* end)
+{
+  mRssDelta = end->mMaxRss - start->mMaxRss;
+
+  for (int i = 0; i < AST_TAG_COUNT; i++)
+  {
+    const AstKindCounts& from = start->mAstCounts[i];
+    const AstKindCounts& to   = end->mAstCounts[i];
+
+    mAstCounts[i].created   = to.created   - from.created;
+    mAstCounts[i].destroyed = to.destroyed - from.destroyed;
+    mAstCounts[i].bytes     = to.bytes     - from.bytes;
+  }
 }
 
 unsigned long Pass::TotalTime() const
@@ -396,6 +538,7 @@ void Pass::Header(FILE* fp)
   fprintf(fp, "    Main ");
   fprintf(fp, "   Check ");
   fprintf(fp, "   Clean ");
+  fprintf(fp, "   Saved ");
 
   fprintf(fp, "    Time    %%  ");
   fprintf(fp, "   Accum    %%  ");
@@ -408,6 +551,7 @@ void Pass::Header(FILE* fp)
   fprintf(fp, "  -------");
   fprintf(fp, "  -------");
   fprintf(fp, "  -------");
+  fprintf(fp, "  -------");
 
   fprintf(fp, "  ------- -----");
   fprintf(fp, "  ------- -----");
@@ -416,7 +560,8 @@ void Pass::Header(FILE* fp)
 
 void Pass::Print(FILE*         fp, 
                  unsigned long accumTime, 
-                 unsigned long totalTime) const
+                 unsigned long totalTime,
+                 double        nodeTime) const
 {
   unsigned long passTime  = TotalTime();
   double        passFrac  = (100.0 * passTime)  / totalTime;
@@ -425,6 +570,7 @@ void Pass::Print(FILE*         fp,
   double        primary   = mPrimary  / 1e6;
   double        verify    = mVerify   / 1e6;
   double        clean     = mCleanAst / 1e6;
+  double        saved     = mCleanSkipped * nodeTime / 1e6;
 
   if (mPassId > 0)
     fprintf(fp, "%4d ", mPassId);
@@ -432,24 +578,93 @@ void Pass::Print(FILE*         fp,
     fprintf(fp, "     ");
 
   fprintf(fp, "%-33s", mName);
-  fprintf(fp, "  %7.3f  %7.3f  %7.3f", primary, verify, clean);
+  fprintf(fp, "  %7.3f  %7.3f  %7.3f  %7.3f", primary, verify, clean, saved);
   fprintf(fp, "  %7.3f %5.1f", passTime  / 1e6, passFrac );
   fprintf(fp, "  %7.3f %5.1f", accumTime / 1e6, accumFrac);
   fprintf(fp, "\n");
 }
 
+void Pass::PrintJson(FILE* fp, bool last) const
+{
+  fprintf(fp, "    {\n");
+  fprintf(fp, "      \"pass\": %d,\n",              mPassId);
+  fprintf(fp, "      \"name\": \"%s\",\n",            mName);
+  fprintf(fp, "      \"mainTime\": %.6f,\n",        mPrimary  / 1e6);
+  fprintf(fp, "      \"checkTime\": %.6f,\n",       mVerify   / 1e6);
+  fprintf(fp, "      \"cleanTime\": %.6f,\n",       mCleanAst / 1e6);
+  fprintf(fp, "      \"cleanExamined\": %d,\n",     mCleanExamined);
+  fprintf(fp, "      \"cleanSkipped\": %d,\n",      mCleanSkipped);
+  fprintf(fp, "      \"peakRssDeltaKB\": %ld,\n",   mRssDelta);
+  fprintf(fp, "      \"ast\": {\n");
+
+  for (int i = 0; i < AST_TAG_COUNT; i++)
+  {
+    fprintf(fp,
+            "        \"%s\": { \"created\": %ld, \"destroyed\": %ld, "
+            "\"bytes\": %ld }%s\n",
+            astTagName((AstTag) i),
+            mAstCounts[i].created,
+            mAstCounts[i].destroyed,
+            mAstCounts[i].bytes,
+            (i < AST_TAG_COUNT - 1) ? "," : "");
+  }
+
+  fprintf(fp, "      }\n");
+  fprintf(fp, "    }%s\n", (last == true) ? "" : ",");
+}
+
+void Pass::HeaderCsv(FILE* fp)
+{
+  fprintf(fp, "pass,name,mainTime,checkTime,cleanTime,");
+  fprintf(fp, "cleanExamined,cleanSkipped,peakRssDeltaKB");
+
+  for (int i = 0; i < AST_TAG_COUNT; i++)
+  {
+    const char* name = astTagName((AstTag) i);
+
+    fprintf(fp, ",%sCreated,%sDestroyed,%sBytes", name, name, name);
+  }
+
+  fprintf(fp, "\n");
+}
+
+void Pass::PrintCsv(FILE* fp) const
+{
+  fprintf(fp, "%d,%s,%.6f,%.6f,%.6f,%d,%d,%ld",
+          mPassId,
+          mName,
+          mPrimary  / 1e6,
+          mVerify   / 1e6,
+          mCleanAst / 1e6,
+          mCleanExamined,
+          mCleanSkipped,
+          mRssDelta);
+
+  for (int i = 0; i < AST_TAG_COUNT; i++)
+  {
+    fprintf(fp, ",%ld,%ld,%ld",
+            mAstCounts[i].created,
+            mAstCounts[i].destroyed,
+            mAstCounts[i].bytes);
+  }
+
+  fprintf(fp, "\n");
+}
+
 void Pass::Footer(FILE*         fp, 
                   unsigned long mainTime,
                   unsigned long checkTime,
                   unsigned long cleanTime,
+                  double        savedTime,
                   unsigned long totalTime)
 {
   fprintf(fp,
-          "\n     %-33s  %7.3f  %7.3f  %7.3f  %7.3f\n",
+          "\n     %-33s  %7.3f  %7.3f  %7.3f  %7.3f  %7.3f\n",
           "total time",
           mainTime / 1e6,
           checkTime / 1e6,
           cleanTime / 1e6,
+          savedTime / 1e6,
           totalTime / 1e6);
 }
 
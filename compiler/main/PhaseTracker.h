@@ -43,6 +43,11 @@
 * d) Stop the timer and generate one or more reports on the time spent in     *
 *    each phase.
 *                                                                             *
+* Each phase also samples the peak resident set size and the number of AST    *
+* nodes of each kind created and destroyed so far, so that ReportProfile()    *
+* can write a machine-readable profile of the memory and time spent in each   *
+* pass.                                                                       *
+*                                                                             *
 * Every phase has a descriptive name that will be used by the reports.        *
 *                                                                             *
 * The main loop for the compiler, in runpasses.cpp, has a notion of a "pass"  *
@@ -79,11 +84,17 @@ public:
 
   void                 Stop();
 
+  // Record the nodes examined and skipped by the current kCleanAst phase
+  void                 CleanAstCounts(int examined, int skipped);
+
   void                 ReportPass  ()                                const;
   void                 ReportTotal ()                                const;
 
   void                 ReportRollup()                                const;
 
+  // Write a per-pass profile as JSON, or as CSV if fileName ends in .csv
+  void                 ReportProfile(const char* fileName)           const;
+
 private:
   void                 PassesCollect(std::vector<Pass>& passes) const;
   
@@ -94,6 +105,7 @@ private:
   Timer                mTimer;
   int                  mPhaseId;
   std::vector<Phase*>  mPhases;
+  Phase*               mStopPhase;   // Usage sampled by Stop()
 };
 
 #endif
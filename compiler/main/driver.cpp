@@ -34,6 +34,7 @@
 #include "log.h"
 #include "misc.h"
 #include "mysystem.h"
+#include "parallelPasses.h"
 #include "PhaseTracker.h"
 #include "primitive.h"
 #include "runpasses.h"
@@ -105,6 +106,7 @@ int fConditionalDynamicDispatchLimit = 0;
 bool fUseNoinit = true;
 bool fNoCopyPropagation = false;
 bool fNoDeadCodeElimination = false;
+bool fSparseCopyPropagation = false;
 bool fNoScalarReplacement = false;
 bool fNoTupleCopyOpt = false;
 bool fNoRemoteValueForwarding = false;
@@ -121,10 +123,12 @@ bool fNoNilChecks = false;
 bool fNoStackChecks = false;
 bool fNoCastChecks = false;
 bool fMungeUserIdents = true;
+bool fIncrementalCompilation = false;
 bool fEnableTaskTracking = false;
 
 bool  printPasses     = false;
 FILE* printPassesFile = NULL;
+char  passesProfileFile[FILENAME_MAX+1] = "";
 
 // flag for llvmWideOpt
 bool fLLVMWideOpt = false;
@@ -145,6 +149,7 @@ bool fRemoveUnreachableBlocks = true;
 bool fMinimalModules = false;
 bool fUseIPE         = false;
 
+int inline_threshold = 8;
 int optimize_on_clause_limit = 20;
 int scalar_replace_limit = 8;
 int tuple_copy_limit = scalar_replace_limit;
@@ -694,6 +699,7 @@ static ArgumentDescription arg_desc[] = {
  {"ignore-local-classes", ' ', NULL, "Disable [enable] local classes", "N", &fIgnoreLocalClasses, NULL, NULL},
  {"inline", ' ', NULL, "Enable [disable] function inlining", "n", &fNoInline, NULL, NULL},
  {"inline-iterators", ' ', NULL, "Enable [disable] iterator inlining", "n", &fNoInlineIterators, "CHPL_DISABLE_INLINE_ITERATORS", NULL},
+ {"inline-threshold", ' ', "<size>", "Automatically inline functions up to <size> calls, 0 to disable", "I", &inline_threshold, "CHPL_INLINE_THRESHOLD", NULL},
  {"live-analysis", ' ', NULL, "Enable [disable] live variable analysis", "n", &fNoLiveAnalysis, "CHPL_DISABLE_LIVE_ANALYSIS", NULL},
  {"optimize-loop-iterators", ' ', NULL, "Enable [disable] optimization of iterators composed of a single loop", "n", &fNoOptimizeLoopIterators, "CHPL_DISABLE_OPTIMIZE_LOOP_ITERATORS", NULL},
  {"vectorize", ' ', NULL, "Enable [disable] generation of vectorization hints", "n", &fNoVectorize, "CHPL_DISABLE_VECTORIZATION", NULL},
@@ -719,6 +725,7 @@ static ArgumentDescription arg_desc[] = {
  {"", ' ', NULL, "C Code Generation Options", NULL, NULL, NULL, NULL},
  {"codegen", ' ', NULL, "[Don't] Do code generation", "n", &no_codegen, "CHPL_NO_CODEGEN", NULL},
  {"cpp-lines", ' ', NULL, "[Don't] Generate #line annotations", "N", &printCppLineno, "CHPL_CG_CPP_LINES", noteCppLinesSet},
+ {"incremental", ' ', NULL, "[Don't] Generate each module as a separate C translation unit and compile them in parallel", "N", &fIncrementalCompilation, "CHPL_INCREMENTAL_COMP", NULL},
  {"max-c-ident-len", ' ', NULL, "Maximum length of identifiers in generated code, 0 for unlimited", "I", &fMaxCIdentLen, "CHPL_MAX_C_IDENT_LEN", NULL},
  {"munge-user-idents", ' ', NULL, "[Don't] Munge user identifiers to avoid naming conflicts with external code", "N", &fMungeUserIdents, "CHPL_MUNGE_USER_IDENTS"},
  {"savec", ' ', "<directory>", "Save generated C code in directory", "P", saveCDir, "CHPL_SAVEC_DIR", verifySaveCDir},
@@ -745,6 +752,7 @@ static ArgumentDescription arg_desc[] = {
  {"print-commands", ' ', NULL, "[Don't] print system commands", "N", &printSystemCommands, "CHPL_PRINT_COMMANDS", NULL},
  {"print-passes", ' ', NULL, "[Don't] print compiler passes", "N", &printPasses, "CHPL_PRINT_PASSES", NULL},
  {"print-passes-file", ' ', "<filename>", "Print compiler passes to <filename>", "S", NULL, "CHPL_PRINT_PASSES_FILE", setPrintPassesFile},
+ {"print-passes-profile", ' ', "<filename>", "Write a JSON (or .csv) time and memory profile of the compiler passes to <filename>", "P", passesProfileFile, "CHPL_PRINT_PASSES_PROFILE", NULL},
 
  {"", ' ', NULL, "Miscellaneous Options", NULL, NULL, NULL, NULL},
 // Support for extern { c-code-here } blocks could be toggled with this
@@ -818,10 +826,12 @@ static ArgumentDescription arg_desc[] = {
  {"local-temp-names", ' ', NULL, "[Don't] Generate locally-unique temp names", "N", &localTempNames, "CHPL_LOCAL_TEMP_NAMES", NULL},
  {"log-deleted-ids-to", ' ', "<filename>", "Log AST id and memory address of each deleted node to the specified file", "P", deletedIdFilename, "CHPL_DELETED_ID_FILENAME", NULL},
  {"memory-frees", ' ', NULL, "Enable [disable] memory frees in the generated code", "n", &fNoMemoryFrees, "CHPL_DISABLE_MEMORY_FREES", NULL},
+ {"pass-threads", ' ', "<n>", "Run function-local optimization passes on <n> threads", "I", &fPassThreads, "CHPL_PASS_THREADS", NULL},
  {"preserve-inlined-line-numbers", ' ', NULL, "[Don't] Preserve file names/line numbers in inlined code", "N", &preserveInlinedLineNumbers, "CHPL_PRESERVE_INLINED_LINE_NUMBERS", NULL},
  {"print-id-on-error", ' ', NULL, "[Don't] print AST id in error messages", "N", &fPrintIDonError, "CHPL_PRINT_ID_ON_ERROR", NULL},
  {"remove-empty-records", ' ', NULL, "Enable [disable] empty record removal", "n", &fNoRemoveEmptyRecords, "CHPL_DISABLE_REMOVE_EMPTY_RECORDS", NULL},
  {"remove-unreachable-blocks", ' ', NULL, "[Don't] remove unreachable blocks after resolution", "N", &fRemoveUnreachableBlocks, "CHPL_REMOVE_UNREACHABLE_BLOCKS", NULL},
+ {"sparse-copy-propagation", ' ', NULL, "[Don't] use def-use chains instead of dataflow sets for global copy propagation", "N", &fSparseCopyPropagation, "CHPL_SPARSE_COPY_PROPAGATION", NULL},
 
  {"minimal-modules", ' ', NULL, "Enable [disable] using minimal modules",               "N", &fMinimalModules, "CHPL_MINIMAL_MODULES", NULL},
  {"print-chpl-home", ' ', NULL, "Print CHPL_HOME and path to this executable and exit", "F", &printChplHome,   NULL,                   NULL},
@@ -848,6 +858,10 @@ static void setupDependentVars() {
     USR_FATAL("This compiler was built without LLVM support");
 #endif
 
+  if (fPassThreads < 1) {
+    USR_FATAL("--pass-threads must be at least 1");
+  }
+
   if (specializeCCode && (strcmp(CHPL_TARGET_ARCH, "unknown") == 0)) {
     USR_WARN("--specialize was set, but CHPL_TARGET_ARCH is 'unknown'. If "
               "you want any specialization to occur please set CHPL_TARGET_ARCH "
@@ -1002,6 +1016,10 @@ int main(int argc, char* argv[]) {
     fclose(printPassesFile);
   }
 
+  if (passesProfileFile[0] != '\0') {
+    tracker.ReportProfile(passesProfileFile);
+  }
+
   clean_exit(0);
 
   return 0;
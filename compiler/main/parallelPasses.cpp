@@ -0,0 +1,103 @@
+/*
+ * Copyright 2004-2015 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "parallelPasses.h"
+
+#include "baseAST.h"
+#include "misc.h"
+
+#include <pthread.h>
+
+int fPassThreads = 1;
+
+//
+// The work shared by the threads of one forEachFunction() call.  Functions
+// are handed out one at a time from 'next' so that a few very large
+// functions do not leave the other threads idle.
+//
+struct FnPassWork {
+  FnSymbol**  fns;
+  int         numFns;
+  void      (*fnPass)(FnSymbol*);
+  int         next;
+  astlocT     astloc;
+};
+
+static void runFnPassWork(FnPassWork* work) {
+  while (true) {
+    int i = __sync_fetch_and_add(&work->next, 1);
+
+    if (i >= work->numFns)
+      break;
+
+    work->fnPass(work->fns[i]);
+  }
+}
+
+static void* fnPassWorker(void* arg) {
+  FnPassWork* work   = (FnPassWork*) arg;
+
+  // Start from the location that was current when the pass was launched.
+  astlocT     astloc = work->astloc;
+
+  currentAstLocPtr = &astloc;
+
+  runFnPassWork(work);
+
+  return NULL;
+}
+
+void forEachFunction(Vec<FnSymbol*>& fns, void (*fnPass)(FnSymbol*)) {
+  int numThreads = (fPassThreads < fns.n) ? fPassThreads : fns.n;
+
+  if (numThreads <= 1) {
+    forv_Vec(FnSymbol, fn, fns) {
+      fnPass(fn);
+    }
+
+    return;
+  }
+
+  // Work from a snapshot; 'fns' is usually one of the global AST vectors.
+  Vec<FnSymbol*> snapshot;
+
+  snapshot.copy(fns);
+
+  FnPassWork work = { snapshot.v, snapshot.n, fnPass, 0, currentAstLoc };
+
+  pthread_t* threads = (pthread_t*) malloc((numThreads - 1) * sizeof(pthread_t));
+
+  astRegistryShared = true;
+
+  for (int i = 0; i < numThreads - 1; i++) {
+    if (pthread_create(&threads[i], NULL, fnPassWorker, &work) != 0)
+      INT_FATAL("unable to create a pass thread");
+  }
+
+  // The main thread takes its share of the functions too.
+  runFnPassWork(&work);
+
+  for (int i = 0; i < numThreads - 1; i++) {
+    pthread_join(threads[i], NULL);
+  }
+
+  astRegistryShared = false;
+
+  free(threads);
+}
@@ -215,6 +215,12 @@ static void runPass(PhaseTracker& tracker, size_t passIndex) {
 
   cleanAst();
 
+  int examined = 0;
+  int skipped  = 0;
+
+  cleanAstStatistics(examined, skipped);
+  tracker.CleanAstCounts(examined, skipped);
+
   //
   // An optional verify pass
   //
@@ -24,7 +24,9 @@
 #include "astutil.h"
 #include "bb.h"
 #include "bitVec.h"
+#include "dominator.h"
 #include "expr.h"
+#include "parallelPasses.h"
 #include "passes.h"
 #include "stlUtil.h"
 #include "stmt.h"
@@ -123,8 +125,10 @@
 //#############################################################################
 
 
-static size_t s_repl_count; ///< The number of pairs replaced by GCP this pass.
-static size_t s_ref_repl_count; ///< The number of references replaced this pass.
+// These are per-thread because copyPropagation() may run on several
+// functions at once (see parallelPasses.h).
+static __thread size_t s_repl_count; ///< The number of pairs replaced by GCP this pass.
+static __thread size_t s_ref_repl_count; ///< The number of references replaced this pass.
 
 
 //#############################################################################
@@ -561,6 +565,18 @@ static CallExpr* derefUse(SymExpr* se)
 }
 
 
+// Returns true if se is a string returned from its function.  See the comment
+// in propagateCopies().
+static bool isStringReturn(SymExpr* se)
+{
+  if (CallExpr* call = toCallExpr(se->parentExpr))
+    if (call->isPrimitive(PRIM_RETURN) &&
+        se->var->typeInfo() == dtString)
+      return true;
+  return false;
+}
+
+
 // Perform updates that effect the copyPropagation transformation.
 static void propagateCopies(std::vector<SymExpr*>& symExprs,
                             AvailableMap& available,
@@ -588,10 +604,8 @@ static void propagateCopies(std::vector<SymExpr*>& symExprs,
         // the return type ends up being narrow (which is not correct).
         // After chapel strings become records, this special-case code can be
         // removed.
-        if (CallExpr* call = toCallExpr(se->parentExpr))
-          if (call->isPrimitive(PRIM_RETURN) &&
-              se->var->typeInfo() == dtString)
-            continue;
+        if (isStringReturn(se))
+          continue;
 #if DEBUG_CP
         if (debug > 0)
           printf("Replacing %s[%d] with %s[%d]\n",
@@ -860,11 +874,12 @@ size_t localCopyPropagation(FnSymbol* fn)
 
 static void createPairSet(std::vector<BitVec*>& set,
                           size_t                nbbs,
-                          size_t                size)
+                          size_t                size,
+                          bool                  sparse)
 {
   // Create a BitVec of length size for each block.
   for (size_t i = 0; i < nbbs; ++i)
-    set.push_back(new BitVec(size));
+    set.push_back(new BitVec(size, sparse));
 }
 
 
@@ -1068,10 +1083,14 @@ size_t globalCopyPropagation(FnSymbol* fn) {
   std::vector<BitVec*> IN;
   std::vector<BitVec*> OUT;
 
-  createPairSet(COPY, nbbs, size);
-  createPairSet(KILL, nbbs, size);
-  createPairSet(IN,   nbbs, size);
-  createPairSet(OUT,  nbbs, size);
+  // Each block generates and kills only a few of the pairs, so COPY and
+  // KILL can be sparse.  IN starts out full, so IN and OUT are dense.
+  bool sparse = nbbs > 0 && BitVec::preferSparse(size, size / nbbs);
+
+  createPairSet(COPY, nbbs, size, sparse);
+  createPairSet(KILL, nbbs, size, sparse);
+  createPairSet(IN,   nbbs, size, false);
+  createPairSet(OUT,  nbbs, size, false);
 
   initCopySets(COPY, ends, nbbs);
 
@@ -1143,6 +1162,265 @@ size_t globalCopyPropagation(FnSymbol* fn) {
 }
 
 
+//#############################################################################
+//# SPARSE COPY PROPAGATION
+//#
+//# An alternative to globalCopyPropagation(), selected by
+//# --sparse-copy-propagation.  Rather than solving for the available pairs
+//# at the start of every block, it looks at each copy
+//#  (move y x)
+//# that is the only definition of y, and replaces the uses of y that the move
+//# dominates with x.  That is legal as long as x cannot change between the
+//# move and the use, which holds if x has no definition other than one that
+//# comes before the move (see below).  The def-use chains come from
+//# buildDefUseMaps(), so the cost grows with the number of uses of the copied
+//# symbols rather than with blocks times pairs.
+//#
+//# A single definition D of x that comes before the move on every path to it
+//# cannot come between the move and a use that the move dominates: a path from
+//# D to such a use that avoided the move could be prefixed with a path from
+//# the entry to D that avoids the move, contradicting the dominance.
+//#
+//# When a use of y is replaced with x, x may itself be a copy; its move is put
+//# back on the worklist so that the new use is forwarded too.
+//#
+//# Copies whose lhs is assigned more than once are left to the local pass.
+//# References are handled conservatively: a symbol whose address is taken is
+//# never treated as a copy or as the source of one.
+//#############################################################################
+
+// The basic block containing a SymExpr, and the index of its statement within
+// that block.
+typedef std::pair<int, int> ExprPosition;
+typedef std::map<SymExpr*, ExprPosition> PositionMap;
+
+
+// Returns true if the statement at a comes before the statement at b on every
+// path from the entry to b.
+static bool precedes(DominatorTree& dominators,
+                     const ExprPosition& a, const ExprPosition& b)
+{
+  if (a.first == b.first)
+    return a.second < b.second;
+  return dominators.strictlyDominates(a.first, b.first);
+}
+
+
+// Returns the number of definitions of sym, or -1 if sym may be changed in a
+// way that the def-use maps do not show.
+static int countDefs(Symbol* sym,
+                     Map<Symbol*,Vec<SymExpr*>*>& defMap,
+                     Map<Symbol*,Vec<SymExpr*>*>& useMap,
+                     std::set<Symbol*>& addressTaken,
+                     PositionMap& positions)
+{
+  if (addressTaken.count(sym) || sym->hasFlag(FLAG_CONCURRENTLY_ACCESSED))
+    return -1;
+
+  int ndefs = 0;
+
+  for_defs(se, defMap, sym) {
+    if (se->parentSymbol) {
+      if (!positions.count(se))
+        return -1;
+      ndefs++;
+    }
+  }
+
+  // The def-use maps and isDef() disagree on some calls, so be conservative.
+  for_uses(se, useMap, sym) {
+    if (se->parentSymbol) {
+      if (!positions.count(se) || isDef(se))
+        return -1;
+      if (isRefUse(se) && !sym->type->symbol->hasFlag(FLAG_REF))
+        return -1;
+    }
+  }
+
+  return ndefs;
+}
+
+
+// If def is the lhs of a copy that sparse copy propagation can use, returns
+// the rhs.  Otherwise, returns NULL.
+static SymExpr* copySource(SymExpr* def,
+                           Map<Symbol*,Vec<SymExpr*>*>& defMap,
+                           Map<Symbol*,Vec<SymExpr*>*>& useMap,
+                           std::set<Symbol*>& addressTaken,
+                           PositionMap& positions,
+                           DominatorTree& dominators)
+{
+  CallExpr* call = toCallExpr(def->parentExpr);
+
+  if (!call ||
+      !(call->isPrimitive(PRIM_MOVE) || call->isPrimitive(PRIM_ASSIGN)) ||
+      call->get(1) != def)
+    return NULL;
+
+  SymExpr* rhe = toSymExpr(call->get(2));
+
+  if (!rhe || rhe->var == def->var)
+    return NULL;
+
+  Symbol* lhs = def->var;
+  Symbol* rhs = rhe->var;
+
+  // As in extractCopies(), a move into a reference from a value is a store
+  // through the reference, not a copy, and volatile symbols are never copied.
+  if (lhs->type->symbol->hasFlag(FLAG_REF) &&
+      !rhs->type->symbol->hasFlag(FLAG_REF))
+    return NULL;
+
+  if (maybeVolatile(def) || maybeVolatile(rhe))
+    return NULL;
+
+  if (countDefs(lhs, defMap, useMap, addressTaken, positions) != 1)
+    return NULL;
+
+  // Immediates never change.
+  if (isVarSymbol(rhs) && toVarSymbol(rhs)->immediate)
+    return rhe;
+
+  int ndefs = countDefs(rhs, defMap, useMap, addressTaken, positions);
+
+  if (ndefs < 0 || ndefs > 1)
+    return NULL;
+
+  if (ndefs == 1) {
+    for_defs(se, defMap, rhs) {
+      if (se->parentSymbol) {
+        if (!precedes(dominators, positions[se], positions[def]))
+          return NULL;
+      }
+    }
+  }
+
+  return rhe;
+}
+
+
+size_t sparseCopyPropagation(FnSymbol* fn)
+{
+  RefMap refs;
+
+  BasicBlock::buildBasicBlocks(fn);
+
+  computeRefMap(fn, refs);
+
+  std::set<Symbol*> addressTaken;
+
+  for (RefMap::iterator i = refs.begin(); i != refs.end(); ++i)
+    addressTaken.insert(i->second);
+
+  Map<Symbol*,Vec<SymExpr*>*> defMap;
+  Map<Symbol*,Vec<SymExpr*>*> useMap;
+
+  buildDefUseMaps(fn, defMap, useMap);
+
+  // Record where each SymExpr appears, and collect the defs in block order so
+  // that the order in which copies are propagated does not depend on the
+  // order of the maps.
+  PositionMap           positions;
+  std::vector<SymExpr*> defs;
+
+  for (size_t i = 0; i < fn->basicBlocks->size(); i++)
+  {
+    BasicBlock* bb = (*fn->basicBlocks)[i];
+
+    for (size_t j = 0; j < bb->exprs.size(); j++)
+    {
+      std::vector<SymExpr*> symExprs;
+
+      collectSymExprsSTL(bb->exprs[j], symExprs);
+
+      for_vector(SymExpr, se, symExprs)
+      {
+        positions[se] = ExprPosition(i, j);
+
+        if (CallExpr* call = toCallExpr(se->parentExpr))
+          if ((call->isPrimitive(PRIM_MOVE) || call->isPrimitive(PRIM_ASSIGN)) &&
+              call->get(1) == se)
+            defs.push_back(se);
+      }
+    }
+  }
+
+  DominatorTree dominators(*fn->basicBlocks);
+
+  std::map<Symbol*, SymExpr*> copies; // y -> the y in (move y x)
+  std::vector<SymExpr*>       worklist;
+  std::set<SymExpr*>          queued;
+
+  // The worklist is a stack; push the copies in reverse so that they are
+  // processed in block order.
+  for (size_t i = defs.size(); i > 0; i--)
+  {
+    SymExpr* def = defs[i-1];
+
+    if (copySource(def, defMap, useMap, addressTaken, positions, dominators))
+    {
+      copies[def->var] = def;
+      worklist.push_back(def);
+      queued.insert(def);
+    }
+  }
+
+  s_repl_count = s_ref_repl_count = 0;
+
+  while (worklist.size() > 0)
+  {
+    SymExpr* def = worklist.back();
+
+    worklist.pop_back();
+    queued.erase(def);
+
+    Symbol*  lhs = def->var;
+    SymExpr* rhe = toSymExpr(toCallExpr(def->parentExpr)->get(2));
+    Symbol*  rhs = rhe->var;
+
+    for_uses(se, useMap, lhs)
+    {
+      // Skip uses that have already been replaced or removed.
+      if (se->var != lhs || !se->parentSymbol)
+        continue;
+
+      if (!isUse(se) || isStringReturn(se))
+        continue;
+
+      if (!positions.count(se) ||
+          !precedes(dominators, positions[def], positions[se]))
+        continue;
+
+#if DEBUG_CP
+      if (debug > 0)
+        printf("Replacing %s[%d] with %s[%d]\n",
+               lhs->name, lhs->id, rhs->name, rhs->id);
+#endif
+      se->var = rhs;
+      ++s_repl_count;
+
+      // Forward the new use of rhs if rhs is a copy too.
+      std::map<Symbol*, SymExpr*>::iterator copy = copies.find(rhs);
+
+      if (copy != copies.end())
+      {
+        addUse(useMap, se);
+
+        if (!queued.count(copy->second))
+        {
+          worklist.push_back(copy->second);
+          queued.insert(copy->second);
+        }
+      }
+    }
+  }
+
+  freeDefUseMaps(defMap, useMap);
+
+  return s_repl_count;
+}
+
+
 // If there is exactly one definition of var by something of reference type, 
 // then return the call that defines it.
 // Otherwise, return NULL.
@@ -1387,26 +1665,31 @@ size_t singleAssignmentRefPropagation(FnSymbol* fn) {
 }
 
 
-void copyPropagation(void) {
-  if (!fNoCopyPropagation) {
-    forv_Vec(FnSymbol, fn, gFnSymbols)
-    {
-      // This test is necessary because extern function stubs may contain
-      // _construct_tuple calls that are unresolved.
-      if (fn->hasFlag(FLAG_EXTERN))
-        continue;
+static void copyPropagation(FnSymbol* fn) {
+  // This test is necessary because extern function stubs may contain
+  // _construct_tuple calls that are unresolved.
+  if (fn->hasFlag(FLAG_EXTERN))
+    return;
 
-      localCopyPropagation(fn);
-      if (!fNoDeadCodeElimination)
-        deadVariableElimination(fn);
+  localCopyPropagation(fn);
+  if (!fNoDeadCodeElimination)
+    deadVariableElimination(fn);
 
-      // Iterate GCP with dead code elimination.
-      while (globalCopyPropagation(fn) > 0)
-      {
-        if (!fNoDeadCodeElimination)
-          deadVariableElimination(fn);
-      }
-    }
+  // Iterate GCP with dead code elimination.
+  while ((fSparseCopyPropagation) ? sparseCopyPropagation(fn) > 0 :
+                                    globalCopyPropagation(fn) > 0)
+  {
+    if (!fNoDeadCodeElimination)
+      deadVariableElimination(fn);
+  }
+}
+
+
+void copyPropagation(void) {
+  if (!fNoCopyPropagation) {
+    // Each function is transformed independently of all others, so the
+    // work can be spread over --pass-threads threads.
+    forEachFunction(gFnSymbols, copyPropagation);
   }
 }
 
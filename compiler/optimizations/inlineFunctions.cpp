@@ -26,6 +26,7 @@
 #include "stmt.h"
 #include "stringutil.h"
 
+#include <algorithm>
 #include <vector>
 
 static bool canRemoveRefTemps(FnSymbol* fn);
@@ -119,7 +120,9 @@ static bool canRemoveRefTemps(FnSymbol* fn) {
   collectCallExprsSTL(fn, callExprs);
 
   for_vector(CallExpr, call, callExprs) {
-    if (!call->primitive) {
+    // a virtual method call is generated as a call through the vmtable,
+    // so like any other call its ref arguments must stay refs
+    if (!call->primitive || call->isPrimitive(PRIM_VIRTUAL_METHOD_CALL)) {
       return false;
     } else if (call->isPrimitive(PRIM_SET_MEMBER)) {
       return false;
@@ -206,6 +209,295 @@ inlineFunction(FnSymbol* fn, Vec<FnSymbol*>& inlinedSet, Vec<FnSymbol*>& canRemo
 }
 
 
+//
+// Automatic inlining of small functions that are not marked inline.
+//
+// A function is a candidate if it is an ordinary normalized function
+// that never writes to its value formals.  Its size is the number of
+// calls (including primitives) in its body, measured after any calls
+// within it have themselves been inlined.  A call site is inlined if
+// the size is within inline_threshold, scaled up for call sites nested
+// in loops and doubled for functions with a single call site.
+//
+
+struct AutoInlineStats {
+  int fns;
+  int calls;
+};
+
+static bool isAutoInlineCandidate(FnSymbol* fn);
+static bool isAutoInlineBody(FnSymbol* fn, bool& mayWrite);
+static bool canAutoInlineCall(FnSymbol* fn, CallExpr* call, bool mayWrite);
+static int  loopDepth(Expr* expr);
+
+static void
+autoInlineFunction(FnSymbol* fn, Vec<FnSymbol*>& visited,
+                   Vec<FnSymbol*>& canRemoveRefTempSet,
+                   AutoInlineStats& stats) {
+  Vec<CallExpr*> calls;
+  bool           mayWrite = false;
+
+  visited.set_add(fn);
+
+  //
+  // inline into the callees of this function first so that its size
+  // reflects what would actually be copied
+  //
+  collectFnCalls(fn, calls);
+
+  forv_Vec(CallExpr, call, calls) {
+    if (call->parentSymbol) {
+      FnSymbol* callee = call->isResolved();
+      if (callee && !visited.set_in(callee))
+        autoInlineFunction(callee, visited, canRemoveRefTempSet, stats);
+    }
+  }
+
+  if (!isAutoInlineCandidate(fn))
+    return;
+
+  Vec<CallExpr*> sites;
+
+  //
+  // chpl_gen_main is left alone: it runs the module initializers before
+  // calling main, but localizeGlobals assumes that the global constants a
+  // function reads are set before the function is entered
+  //
+  forv_Vec(CallExpr, call, *fn->calledBy) {
+    if (call->parentSymbol && call->isResolved() == fn) {
+      FnSymbol* caller = toFnSymbol(call->parentSymbol);
+      if (caller                  &&
+          caller != fn            &&
+          caller != chpl_gen_main &&
+          !caller->hasFlag(FLAG_INLINE))
+        sites.add(call);
+    }
+  }
+
+  if (sites.n == 0)
+    return;
+
+  Vec<CallExpr*> bodyCalls;
+  collectCallExprs(fn->body, bodyCalls);
+
+  //
+  // clean up the body as is done for inline functions before measuring
+  // it, if it has any chance of fitting under the largest limit
+  //
+  if (bodyCalls.n <= inline_threshold << 3) {
+    fn->collapseBlocks();
+
+    removeUnnecessaryGotos(fn);
+
+#if DEBUG_CP < 2    // That is, disabled if DEBUG_CP >= 2
+    if (!fNoCopyPropagation) {
+      singleAssignmentRefPropagation(fn);
+      localCopyPropagation(fn);
+    }
+#endif
+
+    if (!fNoDeadCodeElimination) {
+      deadVariableElimination(fn);
+      deadExpressionElimination(fn);
+    }
+
+    bodyCalls.clear();
+    collectCallExprs(fn->body, bodyCalls);
+  }
+
+  if (!isAutoInlineBody(fn, mayWrite))
+    return;
+
+  int size    = bodyCalls.n;
+  int inlined = 0;
+
+  forv_Vec(CallExpr, call, sites) {
+    int limit = inline_threshold << std::min(loopDepth(call), 2);
+
+    if (sites.n == 1)
+      limit *= 2;
+
+    if (size <= limit && canAutoInlineCall(fn, call, mayWrite)) {
+      inlineCall(fn, call, canRemoveRefTempSet);
+      inlined++;
+    }
+  }
+
+  if (inlined > 0) {
+    stats.fns++;
+    stats.calls += inlined;
+
+    if (report_inlining)
+      printf("chapel compiler: reporting inlining, %s function was inlined "
+             "at %d of %d call sites (size %d)\n",
+             fn->cname, inlined, sites.n, size);
+  }
+}
+
+//
+// Can fn be copied into its callers?  Functions that later passes
+// recognize by their flags, e.g. the allocator and free calls matched by
+// scalar replacement, are left alone.  So are functions that get line
+// and file arguments: errors they report should name their caller's
+// line, and the code generator calls some of them by name (e.g.
+// chpl_nodeFromLocaleID), so they must survive pruning.
+//
+static bool
+isAutoInlineCandidate(FnSymbol* fn) {
+  if (fn->hasFlag(FLAG_INLINE)                     ||
+      fn->hasFlag(FLAG_EXTERN)                     ||
+      fn->hasFlag(FLAG_EXPORT)                     ||
+      fn->hasFlag(FLAG_VIRTUAL)                    ||
+      fn->hasFlag(FLAG_ITERATOR_FN)                ||
+      fn->hasFlag(FLAG_ON)                         ||
+      fn->hasFlag(FLAG_ON_BLOCK)                   ||
+      fn->hasFlag(FLAG_BEGIN)                      ||
+      fn->hasFlag(FLAG_BEGIN_BLOCK)                ||
+      fn->hasFlag(FLAG_COBEGIN_OR_COFORALL)        ||
+      fn->hasFlag(FLAG_COBEGIN_OR_COFORALL_BLOCK)  ||
+      fn->hasFlag(FLAG_LOCAL_ARGS)                 ||
+      fn->hasFlag(FLAG_MODULE_INIT)                ||
+      fn->hasFlag(FLAG_NO_CODEGEN)                 ||
+      fn->hasFlag(FLAG_ALLOCATOR)                  ||
+      fn->hasFlag(FLAG_LOCALE_MODEL_ALLOC)         ||
+      fn->hasFlag(FLAG_LOCALE_MODEL_FREE)          ||
+      fn->hasFlag(FLAG_AUTO_COPY_FN)               ||
+      fn->hasFlag(FLAG_AUTO_DESTROY_FN)            ||
+      fn->hasFlag(FLAG_INIT_COPY_FN)               ||
+      fn->hasFlag(FLAG_DONOR_FN)                   ||
+      fn->hasFlag(FLAG_RUNTIME_TYPE_INIT_FN)       ||
+      fn->hasFlag(FLAG_INSERT_LINE_FILE_INFO)      ||
+      fn == chpl_gen_main                          ||
+      !fn->defPoint->parentSymbol)
+    return false;
+
+  CallExpr* ret = toCallExpr(fn->body->body.last());
+  if (!ret || !ret->isPrimitive(PRIM_RETURN))
+    return false;
+
+  for_formals(formal, fn) {
+    if (formal->hasFlag(FLAG_TYPE_VARIABLE))
+      return false;
+  }
+
+  return true;
+}
+
+//
+// Does the body of fn leave its value formals unchanged?  On success,
+// mayWrite is set if executing fn could modify a variable other than its
+// own locals, through a ref formal or a callee.
+//
+static bool
+isAutoInlineBody(FnSymbol* fn, bool& mayWrite) {
+  mayWrite = false;
+
+  Vec<ArgSymbol*> byValue;
+
+  for_formals(formal, fn) {
+    if ((formal->intent & INTENT_REF) || formal->type->symbol->hasFlag(FLAG_REF))
+      mayWrite = true;
+    else
+      byValue.set_add(formal);
+  }
+
+  Vec<CallExpr*> calls;
+  collectCallExprs(fn->body, calls);
+
+  forv_Vec(CallExpr, call, calls) {
+    if (call->isPrimitive(PRIM_YIELD))
+      return false;
+
+    if (!call->primitive || call->isPrimitive(PRIM_VIRTUAL_METHOD_CALL))
+      mayWrite = true;
+  }
+
+  //
+  // the formals are replaced by the actuals, so a formal that is
+  // passed by value must not be modified or have its address taken
+  //
+  Vec<SymExpr*> symExprs;
+  collectSymExprs(fn->body, symExprs);
+
+  forv_Vec(SymExpr, se, symExprs) {
+    ArgSymbol* formal = toArgSymbol(se->var);
+
+    if (!formal || !byValue.set_in(formal))
+      continue;
+
+    if (isDefAndOrUse(se) & 1)
+      return false;
+
+    if (CallExpr* parent = toCallExpr(se->parentExpr)) {
+      if (parent->isPrimitive(PRIM_ADDR_OF))
+        return false;
+
+      if ((parent->isPrimitive(PRIM_SET_MEMBER) ||
+           parent->isPrimitive(PRIM_SET_SVEC_MEMBER)) &&
+          parent->get(1) == se && !isClass(formal->type))
+        return false;
+    }
+  }
+
+  return true;
+}
+
+//
+// Can call be replaced by a copy of fn's body?  Actuals passed by value
+// must be local to the caller, and if fn may write to memory other
+// than its locals they must also be values that cannot change while fn
+// runs.
+//
+static bool
+canAutoInlineCall(FnSymbol* fn, CallExpr* call, bool mayWrite) {
+  // the body is inserted before the statement, which must be in a list
+  if (!call->getStmtExpr()->list)
+    return false;
+
+  for_formals_actuals(formal, actual, call) {
+    SymExpr* se = toSymExpr(actual);
+
+    if (!se || isTypeSymbol(se->var))
+      return false;
+
+    if ((formal->intent & INTENT_REF) || formal->type->symbol->hasFlag(FLAG_REF))
+      continue;
+
+    Symbol* sym = se->var;
+
+    if (sym->isImmediate() || sym->isParameter())
+      continue;
+
+    if (!sym->defPoint || isModuleSymbol(sym->defPoint->parentSymbol))
+      return false;
+
+    if (mayWrite &&
+        !sym->isConstant()         &&
+        !sym->hasFlag(FLAG_TEMP)   &&
+        !isClass(sym->type)        &&
+        !sym->type->symbol->hasFlag(FLAG_REF))
+      return false;
+  }
+
+  return true;
+}
+
+//
+// number of loops enclosing expr within its function
+//
+static int
+loopDepth(Expr* expr) {
+  int depth = 0;
+
+  for (Expr* parent = expr->parentExpr; parent; parent = parent->parentExpr) {
+    if (isLoopStmt(parent))
+      depth++;
+  }
+
+  return depth;
+}
+
+
 //
 // inline all functions with the inline flag
 // remove unnecessary block statements and gotos
@@ -228,6 +520,28 @@ inlineFunctions() {
       if (fn->hasFlag(FLAG_INLINE) && !inlinedSet.set_in(fn))
         inlineFunction(fn, inlinedSet, canRemoveRefTempSet);
     }
+
+    if (inline_threshold > 0) {
+      Vec<FnSymbol*>  visited;
+      AutoInlineStats stats = { 0, 0 };
+
+      // the bodies of inline functions have been copied into new calls
+      compute_call_sites();
+
+      forv_Vec(FnSymbol, fn, gFnSymbols) {
+        if (!visited.set_in(fn))
+          autoInlineFunction(fn, visited, canRemoveRefTempSet, stats);
+      }
+
+      if (report_inlining)
+        printf("chapel compiler: reporting inlining, %d calls to %d small "
+               "functions were inlined (threshold %d)\n",
+               stats.calls, stats.fns, inline_threshold);
+    }
+
+    // the backend C compiler writes to the same output later
+    if (report_inlining)
+      fflush(stdout);
   }
 
   forv_Vec(FnSymbol, fn, gFnSymbols) {
@@ -68,11 +68,19 @@ liveVariableAnalysis(FnSymbol* fn,
   std::vector<BitVec*> DEF;
   std::vector<BitVec*> IN;
 
+  //
+  // a block only refers to a few of the locals of a large function,
+  // so use sparse sets when the uses and defs per block are few
+  //
+  size_t nbbs = fn->basicBlocks->size();
+  bool sparse = nbbs > 0 &&
+    BitVec::preferSparse(locals.n, (useSet.count() + defSet.count()) / nbbs);
+
   for_vector(BasicBlock, bb, *fn->basicBlocks) {
-    BitVec* use = new BitVec(locals.n);
-    BitVec* def = new BitVec(locals.n);
-    BitVec* lvin = new BitVec(locals.n);
-    BitVec* lvout = new BitVec(locals.n);
+    BitVec* use = new BitVec(locals.n, sparse);
+    BitVec* def = new BitVec(locals.n, sparse);
+    BitVec* lvin = new BitVec(locals.n, sparse);
+    BitVec* lvout = new BitVec(locals.n, sparse);
     for_vector(Expr, expr, bb->exprs) {
       Vec<BaseAST*> asts;
       collect_asts(expr, asts);
@@ -208,7 +208,7 @@ typedef std::map<Symbol*,std::vector<SymExpr*>*> symToVecSymExprMap;
 
 //These two functions are used to collect all natural loops from a bunch of basic blocks and ensure the loops are stored 
 //from most nested to least nested for any give loop nest 
-void collectNaturalLoops(std::vector<Loop*>& loops, BasicBlocks& basicBlocks, BasicBlock* entryBlock, std::vector<BitVec*>& dominators);
+void collectNaturalLoops(std::vector<Loop*>& loops, BasicBlocks& basicBlocks, BasicBlock* entryBlock, DominatorTree& dominators);
 void collectNaturalLoopForEdge(Loop* loop, BasicBlock* header, BasicBlock* tail);
 
 
@@ -230,7 +230,7 @@ void collectNaturalLoopForEdge(Loop* loop, BasicBlock* header, BasicBlock* tail)
  * given nested loop structure the most nested one is guaranteed to appear before (closer to 
  * index 0) than the more outer loops.)
  */
-void collectNaturalLoops(std::vector<Loop*>& loops, BasicBlocks& basicBlocks, BasicBlock* entryBlock, std::vector<BitVec*>& dominators) {
+void collectNaturalLoops(std::vector<Loop*>& loops, BasicBlocks& basicBlocks, BasicBlock* entryBlock, DominatorTree& dominators) {
 
   for_vector(BasicBlock, block, basicBlocks) {
     //Skip entry blocks
@@ -241,7 +241,7 @@ void collectNaturalLoops(std::vector<Loop*>& loops, BasicBlocks& basicBlocks, Ba
     //for each successor 
     for_vector(BasicBlock, successor, block->outs) {
       //if the successor dominates the block, block is a back-edge and successor is a header 
-      if(dominates(successor->id, block->id, dominators)) {
+      if(dominators.dominates(successor->id, block->id)) {
         //check if this loop shares a header with any previous one, and if so combine them into one
         bool sharedHeader = false;
         for_vector(Loop, loop, loops) {
@@ -964,7 +964,7 @@ static void computeLoopInvariants(std::vector<SymExpr*>& loopInvariants, Loop*
  * because that would have the effect of executing first = false before the use. 
  *
  */
-static bool defDominatesAllUses(Loop* loop, SymExpr* def, std::vector<BitVec*>& dominators, std::map<SymExpr*, int>& localMap, symToVecSymExprMap& localUseMap) {
+static bool defDominatesAllUses(Loop* loop, SymExpr* def, DominatorTree& dominators, std::map<SymExpr*, int>& localMap, symToVecSymExprMap& localUseMap) {
   
   if(localUseMap.count(def->var) == 0 ) {
     return false;
@@ -973,7 +973,7 @@ static bool defDominatesAllUses(Loop* loop, SymExpr* def, std::vector<BitVec*>&
   int defBlock = localMap[def];
   
   for_vector(SymExpr, symExpr, *localUseMap[def->var]) {
-    if(dominates(defBlock, localMap[symExpr], dominators) == false) {
+    if(dominators.dominates(defBlock, localMap[symExpr]) == false) {
       return false;
     }
   }
@@ -998,14 +998,14 @@ static bool defDominatesAllUses(Loop* loop, SymExpr* def, std::vector<BitVec*>&
  * where it may be used. 
  *
  */
-static bool defDominatesAllExits(Loop* loop, SymExpr* def, std::vector<BitVec*>& dominators, std::map<SymExpr*, int>& localMap) {
+static bool defDominatesAllExits(Loop* loop, SymExpr* def, DominatorTree& dominators, std::map<SymExpr*, int>& localMap) {
   int defBlock = localMap[def];
   
   BitVec* bitExits = loop->getBitExits();
    
   for(size_t i = 0; i < bitExits->size(); i++) {
     if(bitExits->test(i)) {
-      if(dominates(defBlock, i, dominators) == false) {
+      if(dominators.dominates(defBlock, i) == false) {
         return false;
       }
     }
@@ -1136,17 +1136,11 @@ void loopInvariantCodeMotion(void) {
 
     BasicBlock* entryBlock = basicBlocks[0];
 
-    unsigned nBlocks = basicBlocks.size();
-
     stopTimer(buildBBTimer);
     
     //compute the dominators 
     startTimer(computeDominatorTimer);
-    std::vector<BitVec*> dominators;
-    for(unsigned i = 0; i < nBlocks; i++) {
-      dominators.push_back(new BitVec(nBlocks));
-    }    
-    computeDominators(dominators, basicBlocks);
+    DominatorTree dominators(basicBlocks);
     stopTimer(computeDominatorTimer);
 
     //Collect all of the loops 
@@ -1200,11 +1194,6 @@ void loopInvariantCodeMotion(void) {
       delete loop;
       loop = 0;
     }
-    
-    for_vector(BitVec, bitVec, dominators) {
-      delete bitVec;
-      bitVec = 0;
-    }
   }
 
   stopTimer(overallTimer);
@@ -108,6 +108,7 @@ isFastPrimitive(CallExpr *call, bool isLocal) {
   case PRIM_C_STRING_FROM_STRING:
   case PRIM_CAST_TO_VOID_STAR:
   case PRIM_SIZEOF:
+  case PRIM_STACK_ALLOCATE_CLASS:
 
   case PRIM_GET_USER_LINE:
   case PRIM_GET_USER_FILE:
@@ -75,12 +75,15 @@ reachingDefinitionsAnalysis(FnSymbol* fn,
   std::vector<BitVec*> GEN;
   std::vector<BitVec*> OUT;
 
+  size_t nbbs = fn->basicBlocks->size();
+  bool sparse = nbbs > 0 && BitVec::preferSparse(defs.n, defs.n / nbbs);
+
   for_vector(BasicBlock, bb, *fn->basicBlocks) {
     Vec<Symbol*> bbDefSet;
-    BitVec* kill = new BitVec(defs.n);
-    BitVec* gen = new BitVec(defs.n);
-    BitVec* in = new BitVec(defs.n);
-    BitVec* out = new BitVec(defs.n);
+    BitVec* kill = new BitVec(defs.n, sparse);
+    BitVec* gen = new BitVec(defs.n, sparse);
+    BitVec* in = new BitVec(defs.n, sparse);
+    BitVec* out = new BitVec(defs.n, sparse);
     for (int i = bb->exprs.size()-1; i >= 0; i--) {
       Expr* expr = bb->exprs[i];
       Vec<SymExpr*> symExprs;
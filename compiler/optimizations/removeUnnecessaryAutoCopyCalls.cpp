@@ -262,7 +262,10 @@ static void removeUnnecessaryAutoCopyCalls(FnSymbol* fn) {
       localCopyPropagation(fn);
       if (!fNoDeadCodeElimination)
         deadVariableElimination(fn);
-      globalCopyPropagation(fn);
+      if (fSparseCopyPropagation)
+        sparseCopyPropagation(fn);
+      else
+        globalCopyPropagation(fn);
       singleAssignmentRefPropagation(fn);
     }  
     if (!fNoDeadCodeElimination)
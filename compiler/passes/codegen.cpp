@@ -40,6 +40,8 @@
 #include <cstring>
 #include <cstdio>
 
+#include <unistd.h>
+
 
 // Global so that we don't have to pass around
 // to all of the codegen() routines
@@ -124,6 +126,28 @@ static void legalizeName(Symbol* sym) {
   }
 }
 
+//
+// With --incremental each module is compiled as its own translation unit,
+// so the tables and globals that chpl__header.h used to define may only be
+// defined once, in _main.c.  The module files #define CHPL_GEN_DECLARE_ONLY
+// before including the header and see an extern declaration instead.
+//
+static void
+genDefnStart(FILE* outfile, const char* decl) {
+  if (fIncrementalCompilation) {
+    fprintf(outfile, "#ifdef CHPL_GEN_DECLARE_ONLY\n");
+    fprintf(outfile, "extern %s;\n", decl);
+    fprintf(outfile, "#else\n");
+  }
+}
+
+static void
+genDefnEnd(FILE* outfile) {
+  if (fIncrementalCompilation) {
+    fprintf(outfile, "#endif\n");
+  }
+}
+
 static void
 genGlobalDefClassId(const char* cname, int id) {
   GenInfo* info = gGenInfo;
@@ -132,7 +156,8 @@ genGlobalDefClassId(const char* cname, int id) {
   name += cname;
   
   if( info->cfile ) {
-    fprintf(info->cfile, "const %s %s = %d;\n", 
+    fprintf(info->cfile, "%sconst %s %s = %d;\n",
+                      fIncrementalCompilation ? "static " : "",
                       id_type_name, name.c_str(), id);
   } else {
 #ifdef HAVE_LLVM
@@ -150,7 +175,9 @@ static void
 genGlobalString(const char* cname, const char* value) {
   GenInfo* info = gGenInfo;
   if( info->cfile ) {
+    genDefnStart(info->cfile, astr("const char* ", cname));
     fprintf(info->cfile, "const char* %s = \"%s\";\n", cname, value);
+    genDefnEnd(info->cfile);
   } else {
 #ifdef HAVE_LLVM
     llvm::GlobalVariable *globalString = llvm::cast<llvm::GlobalVariable>(
@@ -167,7 +194,9 @@ static void
 genGlobalInt(const char* cname, int value) {
   GenInfo* info = gGenInfo;
   if( info->cfile ) {
+    genDefnStart(info->cfile, astr("const int ", cname));
     fprintf(info->cfile, "const int %s = %d;\n", cname, value);
+    genDefnEnd(info->cfile);
   } else {
 #ifdef HAVE_LLVM
     llvm::GlobalVariable *globalInt = llvm::cast<llvm::GlobalVariable>(
@@ -199,6 +228,7 @@ genFtable(Vec<FnSymbol*> & fSymbols) {
   const char* ftable_name = "chpl_ftable";
   if( info->cfile ) {
     FILE* hdrfile = info->cfile;
+    genDefnStart(hdrfile, astr("chpl_fn_p ", ftable_name, "[]"));
     fprintf(hdrfile, "chpl_fn_p %s[] = {\n", ftable_name);
     bool first = true;
     forv_Vec(FnSymbol, fn, fSymbols) {
@@ -211,6 +241,7 @@ genFtable(Vec<FnSymbol*> & fSymbols) {
     if (fSymbols.n == 0)
       fprintf(hdrfile, "(chpl_fn_p)0");
     fprintf(hdrfile, "\n};\n");
+    genDefnEnd(hdrfile);
   } else {
 #ifdef HAVE_LLVM
     std::vector<llvm::Constant *> table ((fSymbols.n == 0) ? 1 : fSymbols.n);
@@ -259,6 +290,7 @@ genVirtualMethodTable(Vec<TypeSymbol*>& types) {
     FILE* hdrfile = info->cfile;
     // MPF - in order to simplify code generation, making
     // chpl_vmtable a 1D array.
+    genDefnStart(hdrfile, astr("chpl_fn_p ", vmt, "[]"));
     fprintf(hdrfile, "chpl_fn_p %s[] = {\n", vmt);
     bool comma = false;
     forv_Vec(TypeSymbol, ts, types) {
@@ -289,6 +321,7 @@ genVirtualMethodTable(Vec<TypeSymbol*>& types) {
     if (types.n == 0 || maxVMT == 0)
       fprintf(hdrfile, "(chpl_fn_p)0");
     fprintf(hdrfile, "\n};\n");
+    genDefnEnd(hdrfile);
   } else {
 #ifdef HAVE_LLVM
     const char* vmtData = "chpl_vmtable_data";
@@ -502,6 +535,8 @@ static void codegen_header_compilation_config() {
 
     // generate the "about" function
     fprintf(cfgfile.fptr, "\nvoid chpl_program_about(void);\n");
+    if (fIncrementalCompilation)
+      fprintf(cfgfile.fptr, "#ifndef CHPL_GEN_DECLARE_ONLY\n");
     fprintf(cfgfile.fptr, "\nvoid chpl_program_about() {\n");
 
     fprintf(cfgfile.fptr,
@@ -522,6 +557,8 @@ static void codegen_header_compilation_config() {
     }
 
     fprintf(cfgfile.fptr, "}\n");
+    if (fIncrementalCompilation)
+      fprintf(cfgfile.fptr, "#endif\n");
 
     closeCFile(&cfgfile);
 
@@ -802,6 +839,15 @@ static void codegen_header() {
     // This is done in runClang for LLVM version.
     fprintf(hdrfile, "\n#define CHPL_GEN_CODE\n\n");
 
+    // Global variables are defined in _main.c and declared everywhere else
+    if (fIncrementalCompilation) {
+      fprintf(hdrfile, "#ifdef CHPL_GEN_DECLARE_ONLY\n");
+      fprintf(hdrfile, "#define CHPL_GEN_GLOBAL extern\n");
+      fprintf(hdrfile, "#else\n");
+      fprintf(hdrfile, "#define CHPL_GEN_GLOBAL\n");
+      fprintf(hdrfile, "#endif\n\n");
+    }
+
     // Include sys_basic.h to get C types always defined,
     // proper library .h inclusion
     fprintf(hdrfile, "#include \"sys_basic.h\"\n");
@@ -917,8 +963,10 @@ static void codegen_header() {
   genGlobalInt("chpl_numGlobalsOnHeap", numGlobalsOnHeap);
   int globals_registry_static_size = (numGlobalsOnHeap ? numGlobalsOnHeap : 1);
   if( hdrfile ) {
+    genDefnStart(hdrfile, "ptr_wide_ptr_t chpl_globals_registry[]");
     fprintf(hdrfile, "\nptr_wide_ptr_t chpl_globals_registry[%d];\n",
                      globals_registry_static_size);
+    genDefnEnd(hdrfile);
   } else {
 #ifdef HAVE_LLVM
     llvm::Type* ptr_wide_ptr_t = info->lvt->getType("ptr_wide_ptr_t");
@@ -943,6 +991,7 @@ static void codegen_header() {
   }
   genGlobalInt("chpl_heterogeneous", fHeterogeneous?1:0);
   if( hdrfile ) {
+    genDefnStart(hdrfile, "const char* chpl_mem_descs[]");
     fprintf(hdrfile, "\nconst char* chpl_mem_descs[] = {\n");
     bool first = true;
     forv_Vec(const char*, memDesc, memDescsVec) {
@@ -952,6 +1001,7 @@ static void codegen_header() {
       first = false;
     }
     fprintf(hdrfile, "\n};\n");
+    genDefnEnd(hdrfile);
   } else {
 #ifdef HAVE_LLVM
     std::vector<llvm::Constant *> memDescTable;
@@ -983,6 +1033,7 @@ static void codegen_header() {
   // add table of private-broadcast constants
   //
   if( hdrfile ) {
+    genDefnStart(hdrfile, "void* const chpl_private_broadcast_table[]");
     fprintf(hdrfile, "\nvoid* const chpl_private_broadcast_table[] = {\n");
     fprintf(hdrfile, "&chpl_verbose_comm");
     fprintf(hdrfile, ",\n&chpl_comm_diagnostics");
@@ -1002,6 +1053,7 @@ static void codegen_header() {
       }
     }
     fprintf(hdrfile, "\n};\n");
+    genDefnEnd(hdrfile);
   } else {
 #ifdef HAVE_LLVM
     llvm::Type *private_broadcastTableEntryType =
@@ -1254,8 +1306,6 @@ void codegen(void) {
     openCFile(&mainfile, "_main",        "c");
 
     fprintf(mainfile.fptr, "#include \"chpl__header.h\"\n");
-
-    codegen_makefile(&mainfile);
   }
 
   // This dumps the generated sources into the build directory.
@@ -1292,6 +1342,8 @@ void codegen(void) {
   }
 
   ChainHashMap<char*, StringHashFns, int> filenames;
+  Vec<const char*>                        modulefiles;
+
   forv_Vec(ModuleSymbol, currentModule, allModules) {
     mysystem(astr("# codegen-ing module", currentModule->name),
              "generating comment for --print-commands option");
@@ -1331,9 +1383,19 @@ void codegen(void) {
     openCFile(&modulefile, filename, "c");
     info->cfile = modulefile.fptr;
     
+    if (fIncrementalCompilation) {
+      fprintf(modulefile.fptr, "#define CHPL_GEN_DECLARE_ONLY\n");
+      fprintf(modulefile.fptr, "#include \"chpl__header.h\"\n");
+    }
+
     currentModule->codegenDef();
     closeCFile(&modulefile);
-    fprintf(mainfile.fptr, "#include \"%s%s\"\n", filename, ".c");
+
+    // Each module is either its own translation unit or part of _main.c
+    if (fIncrementalCompilation)
+      modulefiles.add(modulefile.pathname);
+    else
+      fprintf(mainfile.fptr, "#include \"%s%s\"\n", filename, ".c");
   }
 
   if (fHeterogeneous) 
@@ -1345,6 +1407,8 @@ void codegen(void) {
   closeCFile(&hdrfile);
   closeCFile(&mainfile);
 
+  codegen_makefile(&mainfile, NULL, false, &modulefiles);
+
   if (fPrintEmittedCodeSize)
   {
     fprintf(stderr, "Statements emitted: %d\n", gStmtCount);
@@ -1361,7 +1425,18 @@ void makeBinary(void) {
 #endif
   } else {
     const char* makeflags = printSystemCommands ? "-f " : "-s -f ";
+    const char* jobflags  = "";
+
+    // Separate translation units can be compiled in parallel
+    if (fIncrementalCompilation) {
+      long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+      if (ncpus > 1)
+        jobflags = astr("-j", istr((int) ncpus), " ");
+    }
+
     const char* command = astr(astr(CHPL_MAKE, " "),
+                               jobflags,
                                makeflags,
                                getIntermediateDirName(), "/Makefile");
     mysystem(command, "compiling generated source");
@@ -95,12 +95,13 @@
 
 typedef struct {
   bool firstCall;
+  bool onStack;         // bundles live in the spawning task's stack frame
   AggregateType* ctype;
   FnSymbol*  wrap_fn;
 } BundleArgsFnData;
 
 // bundleArgsFnDataInit: the initial value for BundleArgsFnData
-static BundleArgsFnData bundleArgsFnDataInit = { true, NULL, NULL };
+static BundleArgsFnData bundleArgsFnDataInit = { true, false, NULL, NULL };
 
 static void insertEndCounts();
 static void passArgsToNestedFns(Vec<FnSymbol*>& nestedFunctions);
@@ -123,6 +124,10 @@ static void findHeapVarsAndRefs(Map<Symbol*,Vec<SymExpr*>*>& defMap,
 //   create_block_fn_wrapper
 //   call_block_fn_wrapper
 
+// Where it is safe, as for cobegin statements, the bundle is allocated
+// in the spawning task's stack frame instead of on the heap (see
+// canStackAllocateBundles).
+
 // Even though the arg bundle class depends only on the iterator,
 // current code unfortunately uses the call site for some information
 // If there are multiple call sites, the first one is used.
@@ -302,8 +307,13 @@ bundleArgs(CallExpr* fcall, BundleArgsFnData &baData) {
   // create the class variable instance and allocate space for it
   VarSymbol *tempc = newTemp(astr("_args_for", fn->name), ctype);
   fcall->insertBefore( new DefExpr( tempc));
-  insertChplHereAlloc(fcall, false /*insertAfter*/, tempc,
-                      ctype, newMemDesc("bundled args"));
+  if (baData.onStack)
+    fcall->insertBefore(new CallExpr(PRIM_MOVE, tempc,
+                                     new CallExpr(PRIM_STACK_ALLOCATE_CLASS,
+                                                  ctype->symbol)));
+  else
+    insertChplHereAlloc(fcall, false /*insertAfter*/, tempc,
+                        ctype, newMemDesc("bundled args"));
 
   // set the references in the class instance
   int i = 1;
@@ -407,6 +417,8 @@ static void create_block_fn_wrapper(FnSymbol* fn, CallExpr* fcall, BundleArgsFnD
 
   if (fn->hasFlag(FLAG_ON))
     ; // the caller will free the actual
+  else if (baData.onStack)
+    ; // the actual is in the caller's stack frame
   else
     wrap_fn->insertAtTail(callChplHereFree(wrap_c));
 
@@ -1167,6 +1179,45 @@ static void insertEndCounts()
 }
 
 
+// Is 'call' followed, in the same block, by the wait on an end count?
+// The spawning task can't get past that wait, and so can't leave the
+// block or start another trip around an enclosing loop, until the task
+// created by 'call' has finished.
+static bool isFollowedByWaitEndCount(CallExpr* call)
+{
+  for (Expr* stmt = call->next; stmt; stmt = stmt->next) {
+    if (CallExpr* wait = toCallExpr(stmt))
+      if (FnSymbol* waitFn = wait->isResolved())
+        if (!strcmp(waitFn->name, "_waitEndCount"))
+          return true;
+  }
+  return false;
+}
+
+
+// The task created by a cobegin statement finishes before the spawning
+// task gets past the cobegin's _waitEndCount(), so its argument bundle
+// can live in the spawner's stack frame.  Each call site gets its own
+// bundle, so this holds only if no call site can spawn a second task
+// before the wait: a coforall spawns one task per iteration from the
+// same call site, and there the wait is after the loop, not next to
+// the call.  'on' bundles may be sent to another locale and 'begin'
+// tasks may outlive their spawner, so those stay on the heap.
+static bool canStackAllocateBundles(FnSymbol* fn)
+{
+  if (!fn->hasFlag(FLAG_COBEGIN_OR_COFORALL) ||
+      fn->hasFlag(FLAG_BEGIN) ||
+      fn->hasFlag(FLAG_ON))
+    return false;
+
+  forv_Vec(CallExpr, call, *fn->calledBy) {
+    if (!isFollowedByWaitEndCount(call))
+      return false;
+  }
+  return true;
+}
+
+
 // For each "nested" function created to represent remote execution, 
 // bundle args so they can be passed through a fork function.
 // Fork functions in general have the signature
@@ -1180,6 +1231,7 @@ static void passArgsToNestedFns(Vec<FnSymbol*>& nestedFunctions)
   forv_Vec(FnSymbol, fn, nestedFunctions) {
 
     BundleArgsFnData baData = bundleArgsFnDataInit;
+    baData.onStack = canStackAllocateBundles(fn);
 
     forv_Vec(CallExpr, call, *fn->calledBy) {
       SET_LINENO(call);
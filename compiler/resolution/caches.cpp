@@ -23,8 +23,40 @@
 #include "stringutil.h"
 
 
+//
+// Mix a symbol's id into a well-distributed word.  Ids are used rather
+// than addresses so that the hashes do not depend on memory layout.
+//
+static unsigned long
+hashSymbol(Symbol* sym) {
+  unsigned long h = (sym) ? (unsigned long)sym->id : 0;
+  h ^= h >> 16;
+  h *= 0x45d9f3bUL;
+  h ^= h >> 16;
+  h *= 0x45d9f3bUL;
+  h ^= h >> 16;
+  return h;
+}
+
+
+//
+// The pairs are summed so that the hash does not depend on their order.
+// Pairs with a NULL value are skipped because isCacheEntryMatch treats
+// them the same as missing keys.
+//
+static unsigned long
+hashSymbolMap(SymbolMap* map) {
+  unsigned long h = 0;
+  form_Map(SymbolMapElem, e, *map) {
+    if (e->key && e->value)
+      h += hashSymbol(e->key) * 31 + hashSymbol(e->value);
+  }
+  return h;
+}
+
+
 SymbolMapCacheEntry::SymbolMapCacheEntry(FnSymbol* ifn, SymbolMap* imap) :
-  fn(ifn), map(*imap) { }
+  fn(ifn), map(*imap), hash(hashSymbolMap(imap)) { }
 
 
 void
@@ -56,8 +88,9 @@ isCacheEntryMatch(SymbolMap* s1, SymbolMap* s2) {
 FnSymbol*
 checkCache(SymbolMapCache& cache, FnSymbol* oldFn, SymbolMap* map) {
   if (Vec<SymbolMapCacheEntry*>* entries = cache.get(oldFn)) {
+    unsigned long hash = hashSymbolMap(map);
     forv_Vec(SymbolMapCacheEntry, entry, *entries) {
-      if (isCacheEntryMatch(map, &entry->map))
+      if (entry->hash == hash && isCacheEntryMatch(map, &entry->map))
         return entry->fn;
     }
   }
@@ -68,8 +101,9 @@ checkCache(SymbolMapCache& cache, FnSymbol* oldFn, SymbolMap* map) {
 void
 replaceCache(SymbolMapCache& cache, FnSymbol* oldFn, FnSymbol* fn, SymbolMap* map) {
   if (Vec<SymbolMapCacheEntry*>* entries = cache.get(oldFn)) {
+    unsigned long hash = hashSymbolMap(map);
     forv_Vec(SymbolMapCacheEntry, entry, *entries) {
-      if (isCacheEntryMatch(map, &entry->map)) {
+      if (entry->hash == hash && isCacheEntryMatch(map, &entry->map)) {
         entry->fn = fn;
         return;
       }
@@ -91,8 +125,23 @@ freeCache(SymbolMapCache& cache) {
 }
 
 
+//
+// isCacheEntryMatch compares the vectors as sets, so the hash is a
+// signature with one bit set per element: it ignores both order and
+// duplicates.
+//
+static unsigned long
+hashSymbolVec(Vec<Symbol*>* vec) {
+  unsigned long h = 0;
+  forv_Vec(Symbol, sym, *vec) {
+    h |= 1UL << (hashSymbol(sym) % (8 * sizeof(unsigned long)));
+  }
+  return h;
+}
+
+
 SymbolVecCacheEntry::SymbolVecCacheEntry(FnSymbol* ifn, Vec<Symbol*>* ivec) :
-  fn(ifn), vec(*ivec) { }
+  fn(ifn), vec(*ivec), hash(hashSymbolVec(ivec)) { }
 
 
 void
@@ -123,8 +172,9 @@ isCacheEntryMatch(Vec<Symbol*>* vec1, Vec<Symbol*>* vec2) {
 FnSymbol*
 checkCache(SymbolVecCache& cache, FnSymbol* fn, Vec<Symbol*>* vec) {
   if (Vec<SymbolVecCacheEntry*>* entries = cache.get(fn)) {
+    unsigned long hash = hashSymbolVec(vec);
     forv_Vec(SymbolVecCacheEntry, entry, *entries) {
-      if (isCacheEntryMatch(vec, &entry->vec)) {
+      if (entry->hash == hash && isCacheEntryMatch(vec, &entry->vec)) {
         return entry->fn;
       }
     }
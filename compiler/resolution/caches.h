@@ -35,11 +35,17 @@
 //
 //   freeCache(cache): frees memory associated with cache
 //
+//   Each entry also records a hash of its map that does not depend on
+//   the order of the key-value pairs.  checkCache compares the hashes
+//   first and only compares the maps when the hashes agree, so generic
+//   functions with many instantiations are cheap to look up.
+//
 class SymbolMapCacheEntry {
  public:
   SymbolMapCacheEntry(FnSymbol* ifn, SymbolMap* imap);
   FnSymbol* fn;
   SymbolMap map;
+  unsigned long hash;
 };
 typedef Map<FnSymbol*,Vec<SymbolMapCacheEntry*>*> SymbolMapCache;
 typedef MapElem<FnSymbol*,Vec<SymbolMapCacheEntry*>*> SymbolMapCacheElem;
@@ -56,13 +62,15 @@ void freeCache(SymbolMapCache& cache);
 //   This cache works similarly to the SymbolMapCache above except
 //   instead of a map, the cache is based on a vector.  The cache
 //   entries match if the functions are the same and the vectors
-//   contain the same elements (in any order).
+//   contain the same elements (in any order).  The entry hash only
+//   depends on the set of elements.
 //
 class SymbolVecCacheEntry {
  public:
   SymbolVecCacheEntry(FnSymbol* fn, Vec<Symbol*>* ivec);
   FnSymbol* fn;
   Vec<Symbol*> vec;
+  unsigned long hash;
 };
 typedef Map<FnSymbol*,Vec<SymbolVecCacheEntry*>*> SymbolVecCache;
 typedef MapElem<FnSymbol*,Vec<SymbolVecCacheEntry*>*> SymbolVecCacheElem;
@@ -301,6 +301,10 @@ getVisibleFunctions(BlockStmt* block,
                     const char* name,
                     Vec<FnSymbol*>& visibleFns,
                     Vec<BlockStmt*>& visited);
+static void
+getVisibleFunctions(BlockStmt* block,
+                    const char* name,
+                    Vec<FnSymbol*>& visibleFns);
 static Expr* resolve_type_expr(Expr* expr);
 static void makeNoop(CallExpr* call);
 static void resolveDefaultGenericType(CallExpr* call);
@@ -2597,6 +2601,164 @@ static int nVisibleFunctions = 0; // for incremental build
 static Map<BlockStmt*,BlockStmt*> visibilityBlockCache;
 static Vec<BlockStmt*> standardModuleSet;
 
+//
+// visibleFunctionsCache memoizes the complete walk done by
+// getVisibleFunctions: name -> visibility block -> visible functions.
+// The entries for a name are dropped whenever buildVisibleFunctionMap
+// adds a function with that name.
+//
+typedef Map<BlockStmt*,Vec<FnSymbol*>*>      VisibleFunctionsByBlock;
+typedef MapElem<BlockStmt*,Vec<FnSymbol*>*>  VisibleFunctionsByBlockElem;
+typedef MapElem<const char*,VisibleFunctionsByBlock*> VisibleFunctionsCacheElem;
+
+static Map<const char*,VisibleFunctionsByBlock*> visibleFunctionsCache;
+
+static void forgetVisibleFunctions(const char* name) {
+  if (VisibleFunctionsByBlock* byBlock = visibleFunctionsCache.get(name)) {
+    form_Map(VisibleFunctionsByBlockElem, elem, *byBlock) {
+      delete elem->value;
+    }
+    byBlock->clear();
+  }
+}
+
+static void freeVisibleFunctionsCache() {
+  form_Map(VisibleFunctionsCacheElem, elem, visibleFunctionsCache) {
+    forgetVisibleFunctions(elem->key);
+    delete elem->value;
+  }
+  visibleFunctionsCache.clear();
+}
+
+//
+// resolvedCallCache remembers the candidate that disambiguation chose
+// for a call signature so that identical calls made later from the same
+// visibility block skip candidate gathering and disambiguation.  The
+// signature of a call is its cache scope (see getResolvedCallScope), its
+// method tag, and for
+// each actual its type, its name (if named) and an identity symbol: the
+// actual itself for params, the type symbol for type actuals, and NULL
+// otherwise.  Like visibleFunctionsCache, the entries for a name are
+// dropped whenever buildVisibleFunctionMap adds a function with that name.
+//
+class ResolvedCallSignature {
+ public:
+  BlockStmt*       scope;
+  bool             methodTag;
+  Vec<Type*>       types;
+  Vec<Symbol*>     identities;
+  Vec<const char*> actualNames;
+  unsigned long    hash;
+
+  ResolvedCallSignature(CallInfo& info, BlockStmt* iscope);
+  bool operator==(const ResolvedCallSignature& other) const;
+};
+
+class ResolvedCallCacheEntry {
+ public:
+  ResolvedCallSignature signature;
+  FnSymbol*             fn;
+
+  ResolvedCallCacheEntry(const ResolvedCallSignature& isignature,
+                         FnSymbol* ifn) :
+    signature(isignature), fn(ifn) { }
+};
+
+class ResolvedCallBucket {
+ public:
+  Vec<ResolvedCallCacheEntry*> entries;
+  int                          generation; // bumped when entries dropped
+  ResolvedCallBucket() : generation(0) { }
+};
+
+typedef MapElem<const char*,ResolvedCallBucket*> ResolvedCallCacheElem;
+
+static Map<const char*,ResolvedCallBucket*> resolvedCallCache;
+static Vec<BlockStmt*> functionDefiningBlocks; // blocks with FnSymbol defs
+static int resolvedCallCacheHits = 0;
+static int resolvedCallCacheMisses = 0;
+
+static unsigned long hashResolvedCallPart(unsigned long h, BaseAST* ast) {
+  unsigned long x = (ast) ? (unsigned long)ast->id : 0;
+  x ^= x >> 16;
+  x *= 0x45d9f3bUL;
+  x ^= x >> 16;
+  return h * 31 + x;
+}
+
+ResolvedCallSignature::ResolvedCallSignature(CallInfo& info,
+                                             BlockStmt* iscope) :
+  scope(iscope), methodTag(info.call->methodTag), hash(0) {
+  hash = hashResolvedCallPart(hash, scope);
+  hash = hash * 2 + (methodTag ? 1 : 0);
+  for (int i = 0; i < info.actuals.n; i++) {
+    Symbol* actual = info.actuals.v[i];
+    Symbol* identity = NULL;
+    if (actual->hasFlag(FLAG_TYPE_VARIABLE))
+      identity = actual->type->symbol;
+    else if (actual->isParameter())
+      identity = actual;
+    types.add(actual->type);
+    identities.add(identity);
+    actualNames.add(info.actualNames.v[i]);
+    hash = hashResolvedCallPart(hash, actual->type);
+    hash = hashResolvedCallPart(hash, identity);
+    hash = hash * 31 + (unsigned long)(intptr_t)info.actualNames.v[i];
+  }
+}
+
+bool
+ResolvedCallSignature::operator==(const ResolvedCallSignature& other) const {
+  if (hash != other.hash || scope != other.scope ||
+      methodTag != other.methodTag || types.n != other.types.n)
+    return false;
+  for (int i = 0; i < types.n; i++) {
+    if (types.v[i] != other.types.v[i] ||
+        identities.v[i] != other.identities.v[i] ||
+        actualNames.v[i] != other.actualNames.v[i])
+      return false;
+  }
+  return true;
+}
+
+static ResolvedCallBucket* getResolvedCallBucket(const char* name) {
+  ResolvedCallBucket* bucket = resolvedCallCache.get(name);
+  if (!bucket) {
+    bucket = new ResolvedCallBucket();
+    resolvedCallCache.put(name, bucket);
+  }
+  return bucket;
+}
+
+static FnSymbol*
+checkResolvedCallCache(ResolvedCallBucket* bucket,
+                       const ResolvedCallSignature& signature) {
+  forv_Vec(ResolvedCallCacheEntry, entry, bucket->entries) {
+    if (entry->signature == signature)
+      return entry->fn;
+  }
+  return NULL;
+}
+
+static void forgetResolvedCalls(const char* name) {
+  if (ResolvedCallBucket* bucket = resolvedCallCache.get(name)) {
+    forv_Vec(ResolvedCallCacheEntry, entry, bucket->entries) {
+      delete entry;
+    }
+    bucket->entries.clear();
+    bucket->generation++;
+  }
+}
+
+static void freeResolvedCallCache() {
+  form_Map(ResolvedCallCacheElem, elem, resolvedCallCache) {
+    forgetResolvedCalls(elem->key);
+    delete elem->value;
+  }
+  resolvedCallCache.clear();
+  functionDefiningBlocks.clear();
+}
+
 //
 // return true if expr is a CondStmt with chpl__tryToken as its condition 
 //
@@ -2643,6 +2805,29 @@ getVisibilityBlock(Expr* expr) {
   }
 }
 
+//
+// A block that neither defines functions nor uses modules sees the same
+// functions as its parent block, and isMoreVisible ranks them the same
+// way from both, so calls made from such a block share the cache entries
+// of the parent.  The walk stops at parents that getVisibilityBlock
+// would skip (scopeless blocks and the branches of chpl__tryToken
+// conditionals) so that both walks agree on the parent.
+//
+static BlockStmt* getResolvedCallScope(BlockStmt* block) {
+  while (block != rootModule->block &&
+         !isModuleSymbol(block->parentSymbol) &&
+         !block->modUses &&
+         !visibleFunctionMap.get(block) &&
+         !functionDefiningBlocks.set_in(block)) {
+    BlockStmt* next = getParentBlock(block);
+    if (!next || next->blockTag == BLOCK_SCOPELESS ||
+        (next->parentExpr && isTryTokenCond(next->parentExpr)))
+      break;
+    block = next;
+  }
+  return block;
+}
+
 static void buildVisibleFunctionMap() {
   for (int i = nVisibleFunctions; i < gFnSymbols.n; i++) {
     FnSymbol* fn = gFnSymbols.v[i];
@@ -2669,6 +2854,10 @@ static void buildVisibleFunctionMap() {
         vfb->visibleFunctions.put(fn->name, fns);
       }
       fns->add(fn);
+      forgetVisibleFunctions(fn->name);
+      forgetResolvedCalls(fn->name);
+      if (BlockStmt* defBlock = toBlockStmt(fn->defPoint->parentExpr))
+        functionDefiningBlocks.set_add(defBlock);
     }
   }
   nVisibleFunctions = gFnSymbols.n;
@@ -2735,6 +2924,32 @@ getVisibleFunctions(BlockStmt* block,
   return NULL;
 }
 
+//
+// Add the functions named 'name' that are visible from 'block' to
+// visibleFns, reusing the result of an earlier identical walk if the
+// visible function map has not changed for that name since.
+//
+static void
+getVisibleFunctions(BlockStmt* block,
+                    const char* name,
+                    Vec<FnSymbol*>& visibleFns) {
+  VisibleFunctionsByBlock* byBlock = visibleFunctionsCache.get(name);
+  if (!byBlock) {
+    byBlock = new VisibleFunctionsByBlock();
+    visibleFunctionsCache.put(name, byBlock);
+  }
+
+  Vec<FnSymbol*>* fns = byBlock->get(block);
+  if (!fns) {
+    Vec<BlockStmt*> visited;
+    fns = new Vec<FnSymbol*>();
+    getVisibleFunctions(block, name, *fns, visited);
+    byBlock->put(block, fns);
+  }
+
+  visibleFns.append(*fns);
+}
+
 static void handleCaptureArgs(CallExpr* call, FnSymbol* taskFn, CallInfo* info) {
   INT_ASSERT(taskFn);
   if (!needsCapture(taskFn)) {
@@ -3114,64 +3329,105 @@ void resolveNormalCall(CallExpr* call) {
     buildVisibleFunctionMap();
   }
 
-  if (!call->isResolved()) {
-    if (!info.scope) {
-      Vec<BlockStmt*> visited;
-      getVisibleFunctions(getVisibilityBlock(call), info.name, visibleFns, visited);
-    } else {
-      if (VisibleFunctionBlock* vfb = visibleFunctionMap.get(info.scope)) {
-        if (Vec<FnSymbol*>* fns = vfb->visibleFunctions.get(info.name)) {
-          visibleFns.append(*fns);
-        }
-      }
-    }
-  } else {
-    visibleFns.add(call->isResolved());
-    handleCaptureArgs(call, call->isResolved(), &info);
-  }
+  bool explainThisCall = (explainCallLine && explainCallMatch(call)) ||
+    call->id == explainCallID;
 
-  if ((explainCallLine && explainCallMatch(call)) ||
-      call->id == explainCallID)
-  {
-    USR_PRINT(call, "call: %s", toString(&info));
-    if (visibleFns.n == 0)
-      USR_PRINT(call, "no visible functions found");
-    bool first = true;
-    forv_Vec(FnSymbol, visibleFn, visibleFns) {
-      USR_PRINT(visibleFn, "%s %s",
-                first ? "visible functions are:" : "                      ",
-                toString(visibleFn));
-      first = false;
-    }
+  //
+  // look for an earlier resolution of the same call signature; calls
+  // that are being explained always go through the full search
+  //
+  ResolvedCallBucket* bucket = NULL;
+  ResolvedCallSignature* signature = NULL;
+  int generation = 0;
+  ResolutionCandidate* cachedBest = NULL;
+
+  if (!call->isResolved() && !call->partialTag && !explainThisCall) {
+    bucket = getResolvedCallBucket(info.name);
+    generation = bucket->generation;
+    BlockStmt* scope = (info.scope) ? info.scope :
+      getResolvedCallScope(getVisibilityBlock(call));
+    signature = new ResolvedCallSignature(info, scope);
+    if (FnSymbol* fn = checkResolvedCallCache(bucket, *signature)) {
+      cachedBest = new ResolutionCandidate(fn);
+      if (!cachedBest->computeAlignment(info)) {
+        delete cachedBest;
+        cachedBest = NULL;
+      }
+    }
+    if (cachedBest)
+      resolvedCallCacheHits++;
+    else
+      resolvedCallCacheMisses++;
   }
 
   Vec<ResolutionCandidate*> candidates;
-  gatherCandidates(candidates, visibleFns, info);
-
-  if ((explainCallLine && explainCallMatch(info.call)) ||
-      call->id == explainCallID)
-  {
-    if (candidates.n == 0) {
-      USR_PRINT(info.call, "no candidates found");
+  ResolutionCandidate* best = cachedBest;
 
+  if (!best) {
+    if (!call->isResolved()) {
+      if (!info.scope) {
+        getVisibleFunctions(getVisibilityBlock(call), info.name, visibleFns);
+      } else {
+        if (VisibleFunctionBlock* vfb = visibleFunctionMap.get(info.scope)) {
+          if (Vec<FnSymbol*>* fns = vfb->visibleFunctions.get(info.name)) {
+            visibleFns.append(*fns);
+          }
+        }
+      }
     } else {
+      visibleFns.add(call->isResolved());
+      handleCaptureArgs(call, call->isResolved(), &info);
+    }
+
+    if (explainThisCall)
+    {
+      USR_PRINT(call, "call: %s", toString(&info));
+      if (visibleFns.n == 0)
+        USR_PRINT(call, "no visible functions found");
       bool first = true;
-      forv_Vec(ResolutionCandidate*, candidate, candidates) {
-        USR_PRINT(candidate->fn, "%s %s",
-                  first ? "candidates are:" : "               ",
-                  toString(candidate->fn));
+      forv_Vec(FnSymbol, visibleFn, visibleFns) {
+        USR_PRINT(visibleFn, "%s %s",
+                  first ? "visible functions are:" : "                      ",
+                  toString(visibleFn));
         first = false;
       }
     }
-  }
 
-  Expr* scope = (info.scope) ? info.scope : getVisibilityBlock(call);
-  bool explain = fExplainVerbose &&
-    ((explainCallLine && explainCallMatch(call)) ||
-     info.call->id == explainCallID);
-  DisambiguationContext DC(&info.actuals, scope, explain);
+    gatherCandidates(candidates, visibleFns, info);
+
+    if (explainThisCall)
+    {
+      if (candidates.n == 0) {
+        USR_PRINT(info.call, "no candidates found");
+
+      } else {
+        bool first = true;
+        forv_Vec(ResolutionCandidate*, candidate, candidates) {
+          USR_PRINT(candidate->fn, "%s %s",
+                    first ? "candidates are:" : "               ",
+                    toString(candidate->fn));
+          first = false;
+        }
+      }
+    }
+
+    Expr* scope = (info.scope) ? info.scope : getVisibilityBlock(call);
+    bool explain = fExplainVerbose && explainThisCall;
+    DisambiguationContext DC(&info.actuals, scope, explain);
 
-  ResolutionCandidate* best = disambiguateByMatch(candidates, DC);
+    best = disambiguateByMatch(candidates, DC);
+
+    //
+    // remember the choice unless resolving this call added functions
+    // with the same name, which could have changed the candidates
+    //
+    if (signature && best && best->fn &&
+        bucket->generation == generation) {
+      bucket->entries.add(new ResolvedCallCacheEntry(*signature, best->fn));
+    }
+  }
+
+  delete signature;
 
   if (best && best->fn) {
     /*
@@ -3223,6 +3479,8 @@ void resolveNormalCall(CallExpr* call) {
     delete candidate;
   }
 
+  delete cachedBest;
+
   if (call->partialTag) {
     if (!resolvedFn) {
       return;
@@ -4132,8 +4390,7 @@ createFunctionAsValue(CallExpr *call) {
   const char *flname = use->unresolved;
 
   Vec<FnSymbol*> visibleFns;
-  Vec<BlockStmt*> visited;
-  getVisibleFunctions(getVisibilityBlock(call), flname, visibleFns, visited);
+  getVisibleFunctions(getVisibilityBlock(call), flname, visibleFns);
 
   if (visibleFns.n > 1) {
     USR_FATAL(call, "%s: can not capture overloaded functions as values",
@@ -4287,9 +4544,8 @@ usesOuterVars(FnSymbol* fn, Vec<FnSymbol*> &seen) {
 
       //dive into calls
       Vec<FnSymbol*> visibleFns;
-      Vec<BlockStmt*> visited;
 
-      getVisibleFunctions(getVisibilityBlock(call), call->parentSymbol->name, visibleFns, visited);
+      getVisibleFunctions(getVisibilityBlock(call), call->parentSymbol->name, visibleFns);
 
       forv_Vec(FnSymbol, called_fn, visibleFns) {
         bool seen_this_fn = false;
@@ -6759,6 +7015,12 @@ resolve() {
   }
   visibleFunctionMap.clear();
   visibilityBlockCache.clear();
+  freeVisibleFunctionsCache();
+  freeResolvedCallCache();
+
+  if (fPrintStatistics[0] != '\0')
+    fprintf(stderr, "resolution cache: %d hits, %d misses\n",
+            resolvedCallCacheHits, resolvedCallCacheMisses);
 
   forv_Vec(BlockStmt, stmt, gBlockStmts) {
     stmt->moduleUseClear();
@@ -518,7 +518,34 @@ void genIncludeCommandLineHeaders(FILE* outfile) {
 }
 
 
-void codegen_makefile(fileinfo* mainfile, const char** tmpbinname, bool skip_compile_link) {
+//
+// With --incremental the generated modules are listed alongside _main.c
+// and each is compiled to its own object file; CHPL_GEN_OBJS tells the
+// runtime's Makefile.exe (or .shared/.static) to link those objects rather
+// than compiling CHPLSRC as a single translation unit.
+//
+static void genModuleObjFiles(FILE*             makefile,
+                              fileinfo*         mainfile,
+                              Vec<const char*>* moduleFiles) {
+  fprintf(makefile, "CHPL_GEN_OBJS = \\\n");
+  fprintf(makefile, "\t%s.o \\\n", mainfile->pathname);
+  if (moduleFiles) {
+    forv_Vec(const char*, moduleFile, *moduleFiles) {
+      fprintf(makefile, "\t%s.o \\\n", moduleFile);
+    }
+  }
+  fprintf(makefile, "\n");
+}
+
+static void genModuleObjBuildRules(FILE* makefile) {
+  fprintf(makefile, "$(CHPL_GEN_OBJS): %%.c.o: %%.c\n");
+  fprintf(makefile,
+          "\t$(CC) $(GEN_CFLAGS) $(COMP_GEN_CFLAGS) -c -o $@ "
+          "$(CHPL_RT_INC_DIR) $<\n");
+  fprintf(makefile, "\n");
+}
+
+void codegen_makefile(fileinfo* mainfile, const char** tmpbinname, bool skip_compile_link, Vec<const char*>* moduleFiles) {
   fileinfo makefile;
   openCFile(&makefile, "Makefile");
   const char* tmpDirName = intDirName;
@@ -606,7 +633,16 @@ void codegen_makefile(fileinfo* mainfile, const char** tmpbinname, bool skip_com
   fprintf(makefile.fptr, "\n");
 
   fprintf(makefile.fptr, "CHPLSRC = \\\n");
-  fprintf(makefile.fptr, "\t%s \\\n\n", mainfile->pathname);
+  fprintf(makefile.fptr, "\t%s \\\n", mainfile->pathname);
+  if (moduleFiles) {
+    forv_Vec(const char*, moduleFile, *moduleFiles) {
+      fprintf(makefile.fptr, "\t%s \\\n", moduleFile);
+    }
+  }
+  fprintf(makefile.fptr, "\n");
+  if (fIncrementalCompilation) {
+    genModuleObjFiles(makefile.fptr, mainfile, moduleFiles);
+  }
   genCFiles(makefile.fptr);
   genObjFiles(makefile.fptr);
   fprintf(makefile.fptr, "\nLIBS =");
@@ -638,6 +674,9 @@ void codegen_makefile(fileinfo* mainfile, const char** tmpbinname, bool skip_com
   }
   fprintf(makefile.fptr, "\n");
   genCFileBuildRules(makefile.fptr);
+  if (fIncrementalCompilation) {
+    genModuleObjBuildRules(makefile.fptr);
+  }
   closeCFile(&makefile, false);
 }
 
@@ -47,6 +47,15 @@ module ChapelIO {
     proc writeBytes(x, len:ssize_t) {
       halt("Generic Writer.writeBytes called");
     }
+    // Writes the n ints or reals starting at x, with sep between them.
+    // Writers that can do better than one element at a time override
+    // this.
+    proc writePrimitives(x:_ddata, n:int, sep:ioLiteral) {
+      for i in 0..#n {
+        if i > 0 then writeIt(sep);
+        writeIt(x(i));
+      }
+    }
     proc writeIt(x:?t) {
       if _isIoPrimitiveTypeOrNewline(t) {
         writePrimitive(x);
@@ -217,6 +226,15 @@ module ChapelIO {
     proc readBytes(x, len:ssize_t) {
       halt("Generic Reader.readBytes called");
     }
+    // Reads n ints or reals into x, with sep between them.  Readers
+    // that can do better than one element at a time override this.
+    proc readPrimitives(x:_ddata, n:int, sep:ioLiteral) {
+      var lit = sep;
+      for i in 0..#n {
+        if i > 0 then readIt(lit);
+        readIt(x(i));
+      }
+    }
     proc readIt(x:?t) where isClassType(t) {
       // FUTURE -- write the class name/ID? or nil?
       // possibly in a different 'Reader'
@@ -1040,6 +1040,16 @@ module DefaultRectangular {
   proc DefaultRectangularDom.dsiSerialRead(f: Reader) { this.dsiSerialReadWrite(f); }
 
   proc DefaultRectangularArr.dsiSerialReadWrite(f /*: Reader or Writer*/) {
+    // In text mode, a row of ints or reals whose elements are adjacent
+    // in memory, in the order they are written, can be passed to the
+    // Writer or Reader all at once.
+    type strType = chpl__signedType(idxType);
+    const rowStep = if stridable
+                    then blk(rank):strType * dom.ranges(rank).stride /
+                         abs(str(rank))
+                    else blk(rank):strType;
+    const bulkRows = _isArrayIoType(eltType) && !f.binary() && rowStep == 1;
+
     proc recursiveArrayWriter(in idx: rank*idxType, dim=1, in last=false) {
       var binary = f.binary();
       type strType = chpl__signedType(idxType);
@@ -1047,11 +1057,19 @@ module DefaultRectangular {
       if dim == rank {
         var first = true;
         if debugDefaultDist && f.writing then f.writeln(dom.ranges(dim));
-        for j in dom.ranges(dim) by makeStridePositive {
-          if first then first = false;
-          else if ! binary then f <~> new ioLiteral(" ");
-          idx(dim) = j;
-          f <~> dsiAccess(idx);
+        if bulkRows {
+          idx(dim) = dom.ranges(dim).alignedLow;
+          const row = _ddata_shift(eltType, theData, getDataIndex(idx));
+          const n = dom.ranges(dim).length: int;
+          if f.writing then f.writePrimitives(row, n, new ioLiteral(" "));
+          else f.readPrimitives(row, n, new ioLiteral(" "));
+        } else {
+          for j in dom.ranges(dim) by makeStridePositive {
+            if first then first = false;
+            else if ! binary then f <~> new ioLiteral(" ");
+            idx(dim) = j;
+            f <~> dsiAccess(idx);
+          }
         }
       } else {
         for j in dom.ranges(dim) by makeStridePositive {
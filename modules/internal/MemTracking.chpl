@@ -28,15 +28,20 @@ module MemTracking
     memLeaksTable: bool = false,
     memMax: uint = 0,
     memThreshold: uint = 0,
+    memProfile: uint = 0,
+    memProfilePeriod: uint = 0,
     memLog: c_string = "";
 
   pragma "no auto destroy"
   config const
     memLeaksLog: c_string = "";
 
-  // Safely cast to size_t instances of memMax and memThreshold.
+  // Safely cast to size_t instances of memMax, memThreshold, and the
+  // memory profiling settings.
   const cMemMax = memMax.safeCast(size_t),
-    cMemThreshold = memThreshold.safeCast(size_t);
+    cMemThreshold = memThreshold.safeCast(size_t),
+    cMemProfile = memProfile.safeCast(size_t),
+    cMemProfilePeriod = memProfilePeriod.safeCast(size_t);
 
   // Globally accessible copy of the corresponding c_string consts
   use NewString;
@@ -62,6 +67,8 @@ module MemTracking
                                          ref ret_memLeaksTable: bool,
                                          ref ret_memMax: size_t,
                                          ref ret_memThreshold: size_t,
+                                         ref ret_memProfile: size_t,
+                                         ref ret_memProfilePeriod: size_t,
                                          ref ret_memLog: c_string,
                                          ref ret_memLeaksLog: c_string) {
     ret_memTrack = memTrack;
@@ -70,6 +77,8 @@ module MemTracking
     ret_memLeaksTable = memLeaksTable;
     ret_memMax = cMemMax;
     ret_memThreshold = cMemThreshold;
+    ret_memProfile = cMemProfile;
+    ret_memProfilePeriod = cMemProfilePeriod;
 
     if (here.id != 0) {
       // These c_strings are going to be leaked
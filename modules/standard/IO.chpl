@@ -153,7 +153,10 @@ extern const QIO_HINT_NOREUSE:c_int;
  */
 const IOHINT_NONE = 0:c_int;
 
-/** RANDOM means we expect random access to a file */
+/** RANDOM means we expect random access to a file.
+    Channels reading the file will not ask the OS to
+    read ahead of them.
+ */
 const IOHINT_RANDOM = QIO_HINT_RANDOM;
 
 /*  SEQUENTIAL means expect sequential access. On
@@ -187,6 +190,12 @@ extern const QIO_CHANNEL_PTR_NULL:qio_channel_ptr_t;
 extern type qbuffer_ptr_t;
 extern const QBUFFER_PTR_NULL:qbuffer_ptr_t;
 
+// the data that an ioView points into.
+extern type qbytes_ptr_t;
+extern const QBYTES_PTR_NULL:qbytes_ptr_t;
+extern proc qbytes_retain(qb:qbytes_ptr_t);
+extern proc qbytes_release(qb:qbytes_ptr_t);
+
 extern type style_char_t = uint(8);
 
 extern const QIO_STRING_FORMAT_WORD:uint(8);
@@ -355,6 +364,9 @@ extern proc qio_channel_read_complex(threadsafe:c_int, byteorder:c_int, ch:qio_c
 extern proc qio_channel_write_complex(threadsafe:c_int, byteorder:c_int, ch:qio_channel_ptr_t, const ref re_ptr, const ref im_ptr, len:size_t):syserr;
 
 extern proc qio_channel_read_string(threadsafe:c_int, byteorder:c_int, str_style:int(64), ch:qio_channel_ptr_t, ref s:c_string_copy, ref len:int(64), maxlen:ssize_t):syserr;
+extern proc qio_channel_read_view(threadsafe:c_int, ch:qio_channel_ptr_t, term:uint(8), ref bytes_out:qbytes_ptr_t, ref ptr_out:c_ptr(uint(8)), ref len_out:int(64)):syserr;
+pragma "no prototype"
+extern proc qio_strndup(ptr:c_ptr(uint(8)), len:size_t):c_string_copy;
 extern proc qio_channel_write_string(threadsafe:c_int, byteorder:c_int, str_style:int(64), ch:qio_channel_ptr_t, const s:c_string, len:ssize_t):syserr;
 
 extern proc qio_channel_scan_int(threadsafe:c_int, ch:qio_channel_ptr_t, ref ptr, len:size_t, issigned:c_int):syserr;
@@ -365,6 +377,13 @@ extern proc qio_channel_scan_float(threadsafe:c_int, ch:qio_channel_ptr_t, ref p
 pragma "no prototype" // FIXME
 extern proc qio_channel_print_float(threadsafe:c_int, ch:qio_channel_ptr_t, const ref ptr, len:size_t):syserr;
 
+// These read or write a whole array of ints or reals, with sep between
+// the elements.
+extern proc qio_channel_scan_int_array(threadsafe:c_int, ch:qio_channel_ptr_t, ptr:_ddata, len:size_t, issigned:c_int, nmemb:ssize_t, const sep:c_string, seplen:ssize_t, skipws:c_int):syserr;
+extern proc qio_channel_print_int_array(threadsafe:c_int, ch:qio_channel_ptr_t, const ptr:_ddata, len:size_t, issigned:c_int, nmemb:ssize_t, const sep:c_string, seplen:ssize_t):syserr;
+extern proc qio_channel_scan_float_array(threadsafe:c_int, ch:qio_channel_ptr_t, ptr:_ddata, len:size_t, nmemb:ssize_t, const sep:c_string, seplen:ssize_t, skipws:c_int):syserr;
+extern proc qio_channel_print_float_array(threadsafe:c_int, ch:qio_channel_ptr_t, const ptr:_ddata, len:size_t, nmemb:ssize_t, const sep:c_string, seplen:ssize_t):syserr;
+
 // These are the same as scan/print float but they assume an 'i' afterwards.
 extern proc qio_channel_scan_imag(threadsafe:c_int, ch:qio_channel_ptr_t, ref ptr, len:size_t):syserr;
 pragma "no prototype" // FIXME
@@ -459,6 +478,7 @@ extern const QIO_CONV_SET_CAPTURE:c_int;
 extern const QIO_CONV_SET_DONE:c_int;
 
 extern proc qio_conv_parse(const fmt:c_string, start:size_t, ref end:uint(64), scanning:c_int, ref spec:qio_conv_t, ref style:iostyle):syserr;
+extern proc qio_conv_parse_static(const fmt:c_string, start:size_t, ref end:uint(64), scanning:c_int, ref spec:qio_conv_t, ref style:iostyle):syserr;
 
 extern proc qio_format_error_too_many_args():syserr;
 extern proc qio_format_error_too_few_args():syserr;
@@ -1242,6 +1262,10 @@ proc _isSimpleIoType(type t) param return
 proc _isIoPrimitiveType(type t) param return
   _isSimpleIoType(t) || (t == c_string) || (t == string);
 
+// Types that can be read or written as text a whole array at a time.
+proc _isArrayIoType(type t) param return
+  isIntegralType(t) || isRealType(t);
+
  proc _isIoPrimitiveTypeOrNewline(type t) param return
   _isIoPrimitiveType(t) || t == ioNewline || t == ioLiteral || t == ioChar || t == ioBits;
 
@@ -1537,6 +1561,53 @@ inline proc _write_one_internal(_channel_internal:qio_channel_ptr_t, param kind:
   return e;
 }
 
+// Reads n elements into x, with sep between them.
+// Channel must be locked, must be running on this.home
+proc _read_array_internal(_channel_internal:qio_channel_ptr_t, x:_ddata(?t), n:int, sep:ioLiteral):syserr {
+  if _isArrayIoType(t) {
+    if ! qio_channel_binary(_channel_internal) {
+      if isIntegralType(t) {
+        return qio_channel_scan_int_array(false, _channel_internal, x, numBytes(t), isIntType(t), n:ssize_t, sep.val, sep.val.length:ssize_t, sep.ignoreWhiteSpace);
+      } else {
+        return qio_channel_scan_float_array(false, _channel_internal, x, numBytes(t), n:ssize_t, sep.val, sep.val.length:ssize_t, sep.ignoreWhiteSpace);
+      }
+    }
+  }
+
+  var e:syserr = ENOERR;
+  var lit = sep;
+  for i in 0..#n {
+    if i > 0 then e = _read_one_internal(_channel_internal, iokind.dynamic, lit);
+    if e then break;
+    e = _read_one_internal(_channel_internal, iokind.dynamic, x(i));
+    if e then break;
+  }
+  return e;
+}
+
+// Writes the n elements of x, with sep between them.
+// Channel must be locked, must be running on this.home
+proc _write_array_internal(_channel_internal:qio_channel_ptr_t, x:_ddata(?t), n:int, sep:ioLiteral):syserr {
+  if _isArrayIoType(t) {
+    if ! qio_channel_binary(_channel_internal) {
+      if isIntegralType(t) {
+        return qio_channel_print_int_array(false, _channel_internal, x, numBytes(t), isIntType(t), n:ssize_t, sep.val, sep.val.length:ssize_t);
+      } else {
+        return qio_channel_print_float_array(false, _channel_internal, x, numBytes(t), n:ssize_t, sep.val, sep.val.length:ssize_t);
+      }
+    }
+  }
+
+  var e:syserr = ENOERR;
+  for i in 0..#n {
+    if i > 0 then e = _write_one_internal(_channel_internal, iokind.dynamic, sep);
+    if e then break;
+    e = _write_one_internal(_channel_internal, iokind.dynamic, x(i));
+    if e then break;
+  }
+  return e;
+}
+
 inline proc _read_one_internal(_channel_internal:qio_channel_ptr_t, param kind:iokind, ref x:?t):syserr {
   var reader = new ChannelReader(_channel_internal=_channel_internal);
   var err:syserr = ENOERR;
@@ -1785,6 +1856,112 @@ proc channel.readstring(ref str_out:string, len:int(64) = -1):bool {
   }
 }
 
+/* A view of some bytes that a channel read, from channel.readview() or
+   channel.views(). The bytes aren't copied out of the channel's buffer;
+   instead, the view keeps that part of the buffer from being freed.
+   So reading a file a line or field at a time with views doesn't
+   allocate anything per line or field unless it is kept or converted
+   to a string. A view can only be used on the locale of the channel it
+   came from.
+ */
+pragma "ignore noinit"
+record ioView {
+  var home: locale = here;
+  var _bytes_internal:qbytes_ptr_t = QBYTES_PTR_NULL;
+  var _ptr:c_ptr(uint(8));
+  /* The number of bytes in the view */
+  var len:int(64);
+}
+
+pragma "init copy fn"
+proc chpl__initCopy(x: ioView) {
+  on x.home {
+    qbytes_retain(x._bytes_internal);
+  }
+  return x;
+}
+
+proc =(ref ret:ioView, x:ioView) {
+  // retain -- release
+  on x.home {
+    qbytes_retain(x._bytes_internal);
+  }
+
+  on ret.home {
+    qbytes_release(ret._bytes_internal);
+  }
+
+  ret.home = x.home;
+  ret._bytes_internal = x._bytes_internal;
+  ret._ptr = x._ptr;
+  ret.len = x.len;
+}
+
+proc ioView.~ioView() {
+  on this.home {
+    qbytes_release(_bytes_internal);
+    this._bytes_internal = QBYTES_PTR_NULL;
+  }
+}
+
+/* Returns the i'th byte of the view, counting from 1 */
+inline proc ioView.this(i:integral):uint(8) {
+  if boundsChecking && (i < 1 || i > len) then
+    halt("ioView index out of bounds: ", i);
+  return _ptr[i-1];
+}
+
+iter ioView.these():uint(8) {
+  for i in 0..#len do yield _ptr[i];
+}
+
+/* Returns a copy of the bytes as a string */
+proc ioView.toString():string {
+  return toString(qio_strndup(_ptr, len:size_t));
+}
+
+proc ioView.writeThis(f:Writer) {
+  f.write(this.toString());
+}
+
+// channel.readview: read up to the next delimiter, or to EOF if there
+// is no delimiter left, and make v view the bytes read. The delimiter is
+// read but isn't part of the view.
+// return: true  -> v views the bytes that were read
+//         false -> We have encountered EOF or another error
+proc channel.readview(ref v:ioView, delimiter:uint(8) = 0x0a, out error:syserr):bool {
+  if writing then compilerError("read on write-only channel");
+  error = ENOERR;
+  on this.home {
+    var got:ioView;
+    this.lock();
+    error = qio_channel_read_view(false, _channel_internal, delimiter,
+                                  got._bytes_internal, got._ptr, got.len);
+    this.unlock();
+    if !error then v = got;
+  }
+  return !error;
+}
+
+proc channel.readview(ref v:ioView, delimiter:uint(8) = 0x0a):bool {
+  var e:syserr = ENOERR;
+  this.readview(v, delimiter, error=e);
+  if !e then return true;
+  else if e == EEOF then return false;
+  else {
+    this._ch_ioerror(e, "in channel.readview(ref v:ioView, delimiter:uint(8))");
+    return false;
+  }
+}
+
+/* Yields a view of each line, or each run of bytes ending in delimiter,
+   that remains in the channel. */
+iter channel.views(delimiter:uint(8) = 0x0a):ioView {
+  var v:ioView;
+  while this.readview(v, delimiter) do
+    yield v;
+}
+
 inline proc channel.readbits(out v:uint(64), nbits:int(8), out error:syserr):bool {
   var tmp:ioBits;
   var ret:bool;
@@ -2154,6 +2331,14 @@ class ChannelWriter : Writer {
     }
   }
 
+  proc writePrimitives(x:_ddata, n:int, sep:ioLiteral) {
+    if ! err {
+      on this {
+        err = _write_array_internal(_channel_internal, x, n, sep);
+      }
+    }
+  }
+
   proc writeThis(w:Writer) {
     // MPF - I don't understand why I had to add this,
     // but without it test/modules/diten/returnClassDiffModule5.chpl fails.
@@ -2205,6 +2390,14 @@ class ChannelReader : Reader {
     }
   }
 
+  proc readPrimitives(x:_ddata, n:int, sep:ioLiteral) {
+    if ! err {
+      on this {
+        err = _read_array_internal(_channel_internal, x, n, sep);
+      }
+    }
+  }
+
   proc writeThis(w:Writer) {
     compilerError("writeThis on ChannelReader called");
   }
@@ -2604,11 +2797,13 @@ proc channel._match_regexp_if_needed(cur:size_t, len:size_t, ref error:syserr, r
 // be returned in conv and with gotConv = true.
 // Assumes, for a reading channel, that we are withn a mark/revert/commit
 //  in readf. (used in the regexp handling here).
+// If staticFmt is set, fmt is a string literal and its parsed
+// conversions are looked up in (or added to) the runtime's table.
 proc channel._format_reader(
     fmt:c_string, ref cur:size_t, len:size_t, ref error:syserr,
     ref conv:qio_conv_t, ref gotConv:bool, ref style:iostyle,
     ref r:_channel_regexp_info,
-    isReadf:bool)
+    isReadf:bool, staticFmt:bool)
 {
   if _format_debug then stdout.writeln("FORMAT READER ENTRY");
   if r != nil then r.hasRegexp = false;
@@ -2618,7 +2813,10 @@ proc channel._format_reader(
       if error then break;
       if _format_debug then stdout.writeln("TOP OF LOOP cur=", cur, " len=", len);
       var end:uint(64);
-      error = qio_conv_parse(fmt, cur, end, isReadf, conv, style);
+      if staticFmt then
+        error = qio_conv_parse_static(fmt, cur, end, isReadf, conv, style);
+      else
+        error = qio_conv_parse(fmt, cur, end, isReadf, conv, style);
       if error {
         if _format_debug then stdout.writeln("TODO ACC");
       }
@@ -3028,7 +3226,16 @@ proc channel.writef(fmt:string, args ...?k, out error:syserr):bool {
   return this.writef(fmt.c_str(), (...args), error);
 }
 
+// A literal format is parsed only the first time it is used.
+proc channel.writef(param fmt:c_string, args ...?k, out error:syserr):bool {
+  return this._writef(fmt, true, (...args), error);
+}
+
 proc channel.writef(fmt:c_string, args ...?k, out error:syserr):bool {
+  return this._writef(fmt, false, (...args), error);
+}
+
+proc channel._writef(fmt:c_string, staticFmt:bool, args ...?k, out error:syserr):bool {
   if !writing then compilerError("writef on read-only channel");
   error = ENOERR;
   on this.home {
@@ -3060,7 +3267,7 @@ proc channel.writef(fmt:c_string, args ...?k, out error:syserr):bool {
       if j <= i {
         _format_reader(fmt, cur, len, error,
                        conv, gotConv, style, r,
-                       false);
+                       false, staticFmt);
       }
 
       _conv_helper(error, conv, gotConv, j, argType);
@@ -3165,7 +3372,7 @@ proc channel.writef(fmt:c_string, args ...?k, out error:syserr):bool {
         var dummy:c_int;
         _format_reader(fmt, cur, len, error,
                        conv, gotConv, style, r,
-                       false);
+                       false, staticFmt);
       }
 
       if cur < len {
@@ -3186,7 +3393,15 @@ proc channel.writef(fmt:string, out error:syserr):bool {
   return this.writef(fmt.c_str(), error);
 }
 
+proc channel.writef(param fmt:c_string, out error:syserr):bool {
+  return this._writef(fmt, true, error);
+}
+
 proc channel.writef(fmt:c_string, out error:syserr):bool {
+  return this._writef(fmt, false, error);
+}
+
+proc channel._writef(fmt:c_string, staticFmt:bool, out error:syserr):bool {
   if !writing then compilerError("writef on read-only channel");
   error = ENOERR;
   on this.home {
@@ -3204,7 +3419,7 @@ proc channel.writef(fmt:c_string, out error:syserr):bool {
 
     _format_reader(fmt, cur, len, error,
                    conv, gotConv, style, r,
-                   false);
+                   false, staticFmt);
 
     if ! error {
       if gotConv {
@@ -3231,7 +3446,15 @@ proc channel.readf(fmt:string, ref args ...?k, out error:syserr):bool {
   return this.readf(fmt.c_str(), (...args), error);
 }
 
+proc channel.readf(param fmt:c_string, ref args ...?k, out error:syserr):bool {
+  return this._readf(fmt, true, (...args), error);
+}
+
 proc channel.readf(fmt:c_string, ref args ...?k, out error:syserr):bool {
+  return this._readf(fmt, false, (...args), error);
+}
+
+proc channel._readf(fmt:c_string, staticFmt:bool, ref args ...?k, out error:syserr):bool {
   if writing then compilerError("readf on write-only channel");
   error = ENOERR;
   on this.home {
@@ -3262,7 +3485,7 @@ proc channel.readf(fmt:c_string, ref args ...?k, out error:syserr):bool {
         if j <= i {
           _format_reader(fmt, cur, len, error,
                          conv, gotConv, style, r,
-                         true);
+                         true, staticFmt);
 
           if r != nil && r.hasRegexp {
             // We need to handle the next ncaptures arguments.
@@ -3440,7 +3663,7 @@ proc channel.readf(fmt:c_string, ref args ...?k, out error:syserr):bool {
           var dummy:c_int;
           _format_reader(fmt, cur, len, error,
                          conv, gotConv, style, r,
-                         true);
+                         true, staticFmt);
         }
 
         if cur < len {
@@ -3472,7 +3695,15 @@ proc channel.readf(fmt:string, out error:syserr):bool {
   return this.readf(fmt.c_str(), error);
 }
 
+proc channel.readf(param fmt:c_string, out error:syserr):bool {
+  return this._readf(fmt, true, error);
+}
+
 proc channel.readf(fmt:c_string, out error:syserr):bool {
+  return this._readf(fmt, false, error);
+}
+
+proc channel._readf(fmt:c_string, staticFmt:bool, out error:syserr):bool {
   if writing then compilerError("readf on write-only channel");
   error = ENOERR;
   on this.home {
@@ -3493,7 +3724,7 @@ proc channel.readf(fmt:c_string, out error:syserr):bool {
       if _format_debug then stdout.writeln("TODO BBBB");
       _format_reader(fmt, cur, len, error,
                      conv, gotConv, style, r,
-                     true);
+                     true, staticFmt);
       if gotConv {
         error = qio_format_error_too_few_args();
         if _format_debug then stdout.writeln("TODO ABZOO");
@@ -3523,6 +3754,16 @@ proc channel.writef(fmt: string, args ...?k) {
   return this.writef(fmt.c_str(), (...args));
 }
 
+proc channel.writef(param fmt:c_string, args ...?k) {
+  var e:syserr = ENOERR;
+  this.writef(fmt, (...args), error=e);
+  if !e then return true;
+  else {
+    this._ch_ioerror(e, "in channel.writef(fmt:string, ...)");
+    return false;
+  }
+}
+
 proc channel.writef(fmt:c_string, args ...?k) {
   var e:syserr = ENOERR;
   this.writef(fmt, (...args), error=e);
@@ -3537,6 +3778,16 @@ proc channel.writef(fmt: string) {
   return this.writef(fmt.c_str());
 }
 
+proc channel.writef(param fmt:c_string) {
+  var e:syserr = ENOERR;
+  this.writef(fmt, error=e);
+  if !e then return true;
+  else {
+    this._ch_ioerror(e, "in channel.writef(fmt:string, ...)");
+    return false;
+  }
+}
+
 proc channel.writef(fmt:c_string) {
   var e:syserr = ENOERR;
   this.writef(fmt, error=e);
@@ -3551,6 +3802,18 @@ proc channel.readf(fmt:string, ref args ...?k) {
   return this.readf(fmt.c_str(), (...args));
 }
 
+proc channel.readf(param fmt:c_string, ref args ...?k) {
+  var e:syserr = ENOERR;
+  this.readf(fmt, (...args), error=e);
+  if !e then return true;
+  else if e == EEOF then return false;
+  else if e == EFORMAT then return false;
+  else {
+    this._ch_ioerror(e, "in channel.readf(fmt:string, ...)");
+    return false;
+  }
+}
+
 proc channel.readf(fmt:c_string, ref args ...?k) {
   var e:syserr = ENOERR;
   this.readf(fmt, (...args), error=e);
@@ -3567,6 +3830,18 @@ proc channel.readf(fmt:string) {
   return this.readf(fmt.c_str());
 }
 
+proc channel.readf(param fmt:c_string) {
+  var e:syserr = ENOERR;
+  this.readf(fmt, error=e);
+  if !e then return true;
+  else if e == EEOF then return false;
+  else if e == EFORMAT then return false;
+  else {
+    this._ch_ioerror(e, "in channel.readf(fmt:string, ...)");
+    return false;
+  }
+}
+
 proc channel.readf(fmt:c_string) {
   var e:syserr = ENOERR;
   this.readf(fmt, error=e);
@@ -3585,24 +3860,36 @@ proc writef(fmt:c_string, args ...?k):bool {
 proc writef(fmt:string, args ...?k):bool {
   return stdout.writef(fmt, (...args));
 }
+proc writef(param fmt:c_string, args ...?k):bool {
+  return stdout.writef(fmt, (...args));
+}
 proc writef(fmt:c_string):bool {
   return stdout.writef(fmt);
 }
 proc writef(fmt:string):bool {
   return stdout.writef(fmt);
 }
+proc writef(param fmt:c_string):bool {
+  return stdout.writef(fmt);
+}
 proc readf(fmt:c_string, ref args ...?k):bool {
   return stdin.readf(fmt, (...args));
 }
 proc readf(fmt:string, ref args ...?k):bool {
   return stdin.readf(fmt, (...args));
 }
+proc readf(param fmt:c_string, ref args ...?k):bool {
+  return stdin.readf(fmt, (...args));
+}
 proc readf(fmt:c_string):bool {
   return stdin.readf(fmt);
 }
 proc readf(fmt:string):bool {
   return stdin.readf(fmt);
 }
+proc readf(param fmt:c_string):bool {
+  return stdin.readf(fmt);
+}
 
 
 
@@ -3995,6 +4282,85 @@ iter channel.matches(re:regexp, param captures=0, maxmatches:int = max(int))
   if error then this._ch_ioerror(error, "in channel.matches");
 }
 
+/************** Parallel Reading ***************/
+
+// Returns the offset of the first record at or after pos, where each
+// record but the first ends with delimiter. Returns end if no record
+// starts in [pos, end).
+proc file._recordStart(pos:int(64), end:int(64), delimiter:uint(8)):int(64) {
+  var ret = end;
+  on this.home {
+    var r = this.reader(locking=false, start=pos-1, end=end);
+    while true {
+      var got = qio_channel_read_byte(false, r._channel_internal);
+      if got < 0 {
+        var err = (-got):syserr;
+        if err != EEOF then ioerror(err, "in file.chunks", this.tryGetPath());
+        break;
+      }
+      if got == delimiter {
+        ret = qio_channel_offset_unlocked(r._channel_internal);
+        break;
+      }
+    }
+    r.close();
+  }
+  return ret;
+}
+
+// Returns the n+1 boundaries of the chunks that file.chunks yields.
+proc file._chunkBounds(delimiter:uint(8), start:int(64), end:int(64), n:int) {
+  var bounds: [0..n] int(64);
+  const real_end = max(start, min(end, this.length()));
+  const len = real_end - start;
+
+  bounds[0] = start;
+  for i in 1..n-1 {
+    const pos = start + (len / n) * i + min(i, len % n);
+    bounds[i] = if pos <= bounds[i-1] then bounds[i-1]
+                else this._recordStart(pos, real_end, delimiter);
+  }
+  bounds[n] = real_end;
+  return bounds;
+}
+
+/* Splits the bytes of the file from start to end into numChunks pieces
+   of about the same size, moving each split point forward to just
+   after the next delimiter, and yields the (start, end) offsets of the
+   pieces that aren't empty. Each record, i.e. each run of bytes ending
+   with delimiter, is in exactly one piece, so the pieces can be read
+   independently:
+
+     forall (s, e) in f.chunks() {
+       for line in f.lines(start=s, end=e) do ...
+     }
+
+   In a forall loop, the pieces are divided among the tasks. numChunks
+   defaults to the number of tasks a forall loop would use, so each
+   task gets one piece.
+ */
+iter file.chunks(delimiter:uint(8) = 0x0a, start:int(64) = 0, end:int(64) = max(int(64)), numChunks:int = 0): (int(64), int(64)) {
+  const n = _defaultNumChunks(numChunks);
+  const bounds = this._chunkBounds(delimiter, start, end, n);
+  for i in 0..#n do
+    if bounds[i] < bounds[i+1] then yield (bounds[i], bounds[i+1]);
+}
+
+iter file.chunks(param tag:iterKind, delimiter:uint(8) = 0x0a, start:int(64) = 0, end:int(64) = max(int(64)), numChunks:int = 0): (int(64), int(64))
+  where tag == iterKind.standalone {
+  const n = _defaultNumChunks(numChunks);
+  const bounds = this._chunkBounds(delimiter, start, end, n);
+  forall i in 0..#n do
+    if bounds[i] < bounds[i+1] then yield (bounds[i], bounds[i+1]);
+}
+
+proc _defaultNumChunks(numChunks:int) {
+  if numChunks < 0 then halt("file.chunks: numChunks is negative");
+  if numChunks > 0 then return numChunks;
+  return if dataParTasksPerLocale == 0 then here.maxTaskPar
+         else dataParTasksPerLocale;
+}
+
 /************** Distributed File Systems ***************/
 
 extern const FTYPE_NONE   : c_int;
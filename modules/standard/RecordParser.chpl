@@ -122,4 +122,30 @@ class RecordReader {
 
 }
 
+/* Yields the records of type t in the file f, as RecordReader.stream()
+   does for a channel. In a forall loop, the file is split with
+   file.chunks() so that the records in each chunk are parsed by a
+   different task; this requires that no record contains the delimiter
+   except at its end.
+ */
+iter readRecords(f: file, type t, regex: string, delimiter: uint(8) = 0x0a) {
+  var r = f.reader();
+  var N = new RecordReader(t, r, regex);
+  for rec in N.stream() do
+    yield rec;
+  delete N;
+  r.close();
+}
 
+iter readRecords(param tag: iterKind, f: file, type t, regex: string,
+                 delimiter: uint(8) = 0x0a)
+  where tag == iterKind.standalone {
+  forall (s, e) in f.chunks(delimiter) {
+    var r = f.reader(start=s, end=e);
+    var N = new RecordReader(t, r, regex);
+    for rec in N.stream() do
+      yield rec;
+    delete N;
+    r.close();
+  }
+}
@@ -29,8 +29,9 @@
 #include "chpltypes.h"
 #include "error.h"
 
-// Need memory tracking prototypes for inlined memory routines
+// Need memory tracking and profiling prototypes for inlined memory routines
 #include "chplmemtrack.h"
+#include "chpl-mem-profile.h"
 
 // CHPL_MEMHOOKS_ACTIVE=1 will enable the memory hooks;
 // CHPL_MEMHOOKS_ACTIVE will be set to 1 if CHPL_DEBUG is defined;
@@ -86,6 +87,9 @@ void chpl_memhook_malloc_post(void* memAlloc,
     chpl_memhook_check_post(memAlloc, description, lineno, filename);
   if (CHPL_MEMHOOKS_ACTIVE)
     chpl_track_malloc(memAlloc, number, size, description, lineno, filename);
+  if (chpl_memProfile)
+    chpl_mem_profile_malloc(memAlloc, number*size, description,
+                            lineno, filename);
 }
 
 
@@ -97,6 +101,8 @@ void chpl_memhook_free_pre(void* memAlloc,
     chpl_memhook_check_pre(0, 0, 0, lineno, filename);
     chpl_track_free(memAlloc, lineno, filename);
   }
+  if (chpl_memProfile)
+    chpl_mem_profile_free(memAlloc);
 }
 
 
@@ -108,6 +114,8 @@ void chpl_memhook_realloc_pre(void* memAlloc, size_t size,
     chpl_memhook_check_pre(1, size, description, lineno, filename);
     chpl_track_realloc_pre(memAlloc, size, description, lineno, filename);
   }
+  if (chpl_memProfile)
+    chpl_mem_profile_free(memAlloc);
 }
 
 
@@ -121,6 +129,9 @@ void chpl_memhook_realloc_post(void* moreMemAlloc, void* memAlloc,
   if (CHPL_MEMHOOKS_ACTIVE)
     chpl_track_realloc_post(moreMemAlloc, memAlloc, size, description,
                        lineno, filename);
+  if (chpl_memProfile)
+    chpl_mem_profile_malloc(moreMemAlloc, size, description,
+                            lineno, filename);
 }
 
 #endif // LAUNCHER
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2004-2015 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _chpl_mem_pool_H_
+#define _chpl_mem_pool_H_
+
+#ifndef LAUNCHER
+
+#include <stdio.h>
+#include "chpltypes.h"
+#include "chpl-mem-desc.h"
+
+//
+// Per-thread free lists for small fixed-size runtime objects, such as
+// the descriptors the tasking layer creates for every task.  Objects
+// are grouped into power-of-two size classes.  A freed object goes on
+// the freeing thread's list for its class, and the next allocation in
+// that class on that thread reuses it.  The caller passes the object
+// size to chpl_mem_pool_free() as well as to chpl_mem_pool_alloc(), so
+// no header is needed.
+//
+// Memory tracking sees each pool allocation and free as if it went to
+// the heap, so its statistics and leak reports are unchanged.
+//
+void chpl_mem_pool_init(void);
+void* chpl_mem_pool_alloc(size_t size, chpl_mem_descInt_t description,
+                          int32_t lineno, c_string filename);
+void chpl_mem_pool_free(void* memAlloc, size_t size,
+                        int32_t lineno, c_string filename);
+
+void chpl_mem_pool_printStats(FILE* f);
+
+#endif // LAUNCHER
+
+#endif
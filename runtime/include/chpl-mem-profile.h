@@ -0,0 +1,53 @@
+/*
+ * Copyright 2004-2015 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _chpl_mem_profile_H_
+#define _chpl_mem_profile_H_
+
+#ifndef LAUNCHER
+
+#include <stdio.h>
+#include "chpltypes.h"
+#include "chpl-mem-desc.h"
+
+//
+// Sampling heap profiler.  Unlike memory tracking, which records every
+// allocation, this records about one allocation per --memProfile bytes
+// allocated, and attributes each sample to its memory descriptor and
+// source location.  The profile gives the estimated live bytes and
+// allocation rate for each site, at program exit and, if
+// --memProfilePeriod is set, periodically while the program runs.
+//
+// The memory hooks call chpl_mem_profile_malloc() and _free() only
+// while chpl_memProfile is set, so the profiler costs nothing when it
+// is off.
+//
+extern chpl_bool chpl_memProfile;
+
+void chpl_mem_profile_init(size_t interval, size_t period, FILE* f);
+void chpl_mem_profile_malloc(void* memAlloc, size_t size,
+                             chpl_mem_descInt_t description,
+                             int32_t lineno, c_string filename);
+void chpl_mem_profile_free(void* memAlloc);
+
+void chpl_mem_profile_print(void);
+
+#endif // LAUNCHER
+
+#endif
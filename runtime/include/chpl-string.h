@@ -26,8 +26,13 @@ typedef const char* chpl_string;
 
 #ifdef _stdchpl_H_
 /*** only needed for generated code ***/
+#ifdef CHPL_GEN_DECLARE_ONLY
+/* with --incremental, only _main.c defines it */
+extern chpl_string defaultStringValue;
+#else
 chpl_string defaultStringValue="";
 #endif
+#endif
 
 struct chpl_chpl____wide_chpl_string_s;
 
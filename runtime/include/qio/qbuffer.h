@@ -472,6 +472,16 @@ static inline char* qio_strdup(const char* ptr)
   return ret;
 }
 
+static inline char* qio_strndup(const void* ptr, size_t len)
+{
+  char* ret = (char*) qio_malloc(len+1);
+  if( ret ) {
+    memcpy(ret, ptr, len);
+    ret[len] = '\0';
+  }
+  return ret;
+}
+
 typedef chpl_bool qio_bool;
 
 #else
@@ -482,6 +492,7 @@ typedef chpl_bool qio_bool;
 #define qio_free(ptr) free(ptr)
 #define sys_free(ptr) free(ptr)
 #define qio_strdup(ptr) strdup(ptr)
+#define qio_strndup(ptr, len) strndup(ptr, len)
 #define qio_memcpy(dest, src, num) memcpy(dest, src, num)
 
 typedef bool qio_bool;
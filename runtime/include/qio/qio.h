@@ -269,6 +269,7 @@ static inline void qio_lock_destroy(qio_lock_t* x) { int rc = pthread_mutex_dest
 extern ssize_t qio_too_small_for_default_mmap;
 extern ssize_t qio_too_large_for_default_mmap;
 extern ssize_t qio_mmap_chunk_iobufs;
+extern ssize_t qio_readahead_iobufs;
 
 /* Wrap system calls readv, writev, preadv, pwritev
  * to take a buffer.
@@ -785,6 +786,10 @@ typedef struct qio_channel_s {
 
   int64_t av_end;
 
+  // When reading, the end of the range we have most recently asked the
+  // OS to read ahead (see _buffered_read_ahead in qio.c).
+  int64_t readahead_end;
+
   qbuffer_t buf;
 
   // For reading/writing bits (ie less than a byte) at a time
@@ -1238,6 +1243,17 @@ qioerr qio_channel_begin_peek_buffer(const int threadsafe, qio_channel_t* ch, in
 
 qioerr qio_channel_end_peek_buffer(const int threadsafe, qio_channel_t* ch, int64_t advance);
 
+// Reads the bytes up to the next term byte, or up to the end of the
+// channel if there isn't one, and then reads the term byte. Instead of
+// copying the bytes out, this returns the *len_out bytes at *ptr_out,
+// which are within *bytes_out; the caller must release *bytes_out.
+// When the bytes are all in one part of the channel's buffer (which is
+// always the case for an mmap'd file, except at the edges of a
+// mapping), *bytes_out is that part's qbytes, so no copy is made;
+// otherwise they are copied into new qbytes. Returns EEOF if there are
+// no bytes left to read.
+qioerr qio_channel_read_view(const int threadsafe, qio_channel_t* ch, uint8_t term, qbytes_t** bytes_out, uint8_t** ptr_out, int64_t* len_out);
+
 static inline
 qioerr qio_channel_isbuffered(const int threadsafe, qio_channel_t* ch, char* isbuffered)
 {
@@ -422,6 +422,18 @@ qioerr qio_channel_print_int(const int threadsafe, qio_channel_t* restrict ch, c
 qioerr qio_channel_print_float(const int threadsafe, qio_channel_t* restrict ch, const void* restrict ptr, size_t len);
 qioerr qio_channel_print_imag(const int threadsafe, qio_channel_t* restrict ch, const void* restrict ptr, size_t len);
 
+// These read or write nmemb numbers of len bytes each, stored one after
+// another at out or ptr, with the literal sep between them. They do the
+// same as calling the functions above for each number and
+// qio_channel_scan_literal or qio_channel_print_literal for each
+// separator, but take the channel lock only once, and the print
+// functions write the text to the channel a few kilobytes at a time.
+// They stop at the first error.
+qioerr qio_channel_scan_int_array(const int threadsafe, qio_channel_t* restrict ch, void* restrict out, size_t len, int issigned, ssize_t nmemb, const char* restrict sep, ssize_t seplen, int skipws);
+qioerr qio_channel_scan_float_array(const int threadsafe, qio_channel_t* restrict ch, void* restrict out, size_t len, ssize_t nmemb, const char* restrict sep, ssize_t seplen, int skipws);
+qioerr qio_channel_print_int_array(const int threadsafe, qio_channel_t* restrict ch, const void* restrict ptr, size_t len, int issigned, ssize_t nmemb, const char* restrict sep, ssize_t seplen);
+qioerr qio_channel_print_float_array(const int threadsafe, qio_channel_t* restrict ch, const void* restrict ptr, size_t len, ssize_t nmemb, const char* restrict sep, ssize_t seplen);
+
 qioerr qio_channel_scan_complex(const int threadsafe, qio_channel_t* restrict ch, void* restrict re_out, void* restrict im_out, size_t len);
 qioerr qio_channel_print_complex(const int threadsafe, qio_channel_t* restrict ch, const void* restrict re_ptr, const void* im_ptr, size_t len);
 
@@ -830,6 +842,13 @@ void qio_conv_destroy(qio_conv_t* spec);
 void qio_conv_init(qio_conv_t* spec_out);
 qioerr qio_conv_parse(c_string fmt, size_t start, uint64_t* end_out, int scanning, qio_conv_t* spec_out, qio_style_t* style_out);
 
+// Like qio_conv_parse, but remembers each conversion it parses so that
+// parsing the same one again is a table lookup. The cache is keyed by
+// the address of fmt, so fmt must never be freed or modified; in
+// practice, it must be a string literal.
+qioerr qio_conv_parse_static(c_string fmt, size_t start, uint64_t* end_out, int scanning, qio_conv_t* spec_out, qio_style_t* style_out);
+void qio_conv_cache_init(void);
+
 // These error codes can be used by callers to qio_conv_parse
 qioerr qio_format_error_too_many_args(void);
 qioerr qio_format_error_too_few_args(void);
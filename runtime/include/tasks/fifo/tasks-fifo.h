@@ -56,9 +56,14 @@ typedef pthread_cond_t chpl_thread_condvar_t;
 //
 // Sync variables
 //
+// The full/empty state and the lock are bits in a single word, so an
+// uncontended transition is one compare-and-swap.  The mutex and the
+// condition variables are only used by tasks that have to wait.
+//
 typedef struct {
-  volatile chpl_bool  is_full;
-  chpl_thread_mutex_t lock;
+  volatile int_least32_t state;       // full and locked bits
+  volatile int_least32_t waiters;     // tasks waiting on the condvars
+  chpl_thread_mutex_t lock;           // protects the condvars
   chpl_thread_condvar_t signal_full;  // wait for full; signal this when full
   chpl_thread_condvar_t signal_empty; // wait for empty; signal this when empty
   //  threadlayer_sync_aux_t tl_aux;
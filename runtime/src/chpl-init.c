@@ -34,6 +34,7 @@
 #include "chplsys.h"
 #include "config.h"
 #include "error.h"
+#include "qio_formatted.h"
 
 #include <stdint.h>
 #include <string.h>
@@ -188,6 +189,9 @@ void chpl_rt_init(int argc, char* argv[]) {
   // Initialize privatization, needs to happen before hitting module init
   chpl_privatization_init();
 
+  // Set up the table of parsed readf/writef formats.
+  qio_conv_cache_init();
+
   //
   // Some comm layer initialization has to wait until after the
   // tasking layer is initialized.
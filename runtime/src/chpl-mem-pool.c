@@ -0,0 +1,209 @@
+/*
+ * Copyright 2004-2015 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "chplrt.h"
+#include "chpl-mem-pool.h"
+#include "chpl-atomics.h"
+#include "chpl-mem.h"
+#include "chpl-thread-local-storage.h"
+#include "chplmemtrack.h"
+#include <inttypes.h>
+#include <stdint.h>
+
+//
+// Size classes are 2^POOL_MIN_LOG2 .. 2^POOL_MAX_LOG2 bytes.  Larger
+// objects bypass the pools.  Each thread keeps at most POOL_MAX_FREE
+// objects per class; beyond that, frees go back to the heap, so a
+// thread that only ever frees (e.g., one that runs tasks another
+// thread created) doesn't hoard memory.
+//
+#define POOL_MIN_LOG2    5
+#define POOL_MAX_LOG2    9
+#define POOL_NUM_CLASSES (POOL_MAX_LOG2 - POOL_MIN_LOG2 + 1)
+#define POOL_MAX_FREE    256
+
+typedef struct pool_obj {
+  struct pool_obj* next;
+} pool_obj_t;
+
+typedef struct {
+  pool_obj_t* head;
+  int         len;
+  uint64_t    poolAllocs;   // allocations satisfied from the free list
+  uint64_t    heapAllocs;   // allocations that had to go to the heap
+  uint64_t    heapFrees;    // frees that went back to the heap
+} pool_class_t;
+
+typedef struct pool_cache {
+  pool_class_t       classes[POOL_NUM_CLASSES];
+  struct pool_cache* next;  // all caches, for the statistics
+} pool_cache_t;
+
+CHPL_TLS_DECL(pool_cache_t*, pool_cache);
+
+static atomic_uintptr_t all_pool_caches;
+
+
+void chpl_mem_pool_init(void) {
+  CHPL_TLS_INIT(pool_cache);
+  atomic_init_uintptr_t(&all_pool_caches, 0);
+}
+
+
+//
+// The first pool operation on each thread creates its cache.  Caches
+// are never freed; they are few, and the statistics need them.
+//
+static pool_cache_t* get_pool_cache(void) {
+  pool_cache_t* cache = (pool_cache_t*) CHPL_TLS_GET(pool_cache);
+  uintptr_t head;
+
+  if (cache != NULL)
+    return cache;
+
+  cache = (pool_cache_t*) chpl_calloc(1, sizeof(pool_cache_t));
+  if (cache == NULL)
+    return NULL;
+
+  do {
+    head = atomic_load_uintptr_t(&all_pool_caches);
+    cache->next = (pool_cache_t*) head;
+  } while (!atomic_compare_exchange_strong_uintptr_t(&all_pool_caches, head,
+                                                     (uintptr_t) cache));
+
+  CHPL_TLS_SET(pool_cache, cache);
+  return cache;
+}
+
+
+static inline int size_to_class(size_t size) {
+  int log2 = POOL_MIN_LOG2;
+
+  while (((size_t) 1 << log2) < size)
+    log2++;
+  return log2 - POOL_MIN_LOG2;
+}
+
+
+void* chpl_mem_pool_alloc(size_t size, chpl_mem_descInt_t description,
+                          int32_t lineno, c_string filename) {
+  pool_cache_t* cache;
+  pool_class_t* cls;
+  void* memAlloc;
+
+  if (size > ((size_t) 1 << POOL_MAX_LOG2))
+    return chpl_mem_alloc(size, description, lineno, filename);
+
+  cache = get_pool_cache();
+  if (cache == NULL)
+    return chpl_mem_alloc(size, description, lineno, filename);
+
+  cls = &cache->classes[size_to_class(size)];
+
+  chpl_memhook_malloc_pre(1, size, description, lineno, filename);
+  if (cls->head != NULL) {
+    memAlloc = cls->head;
+    cls->head = cls->head->next;
+    cls->len--;
+    if (chpl_memTrack)
+      cls->poolAllocs++;
+  } else {
+    // Allocate the whole class size, so any object in the class fits
+    // when this one is reused.  Tracking records the requested size.
+    memAlloc = chpl_malloc((size_t) 1 << (size_to_class(size)
+                                          + POOL_MIN_LOG2));
+    if (chpl_memTrack)
+      cls->heapAllocs++;
+  }
+  chpl_memhook_malloc_post(memAlloc, 1, size, description, lineno, filename);
+
+  return memAlloc;
+}
+
+
+void chpl_mem_pool_free(void* memAlloc, size_t size,
+                        int32_t lineno, c_string filename) {
+  pool_cache_t* cache;
+  pool_class_t* cls;
+
+  if (size > ((size_t) 1 << POOL_MAX_LOG2)) {
+    chpl_mem_free(memAlloc, lineno, filename);
+    return;
+  }
+
+  cache = get_pool_cache();
+  if (cache == NULL) {
+    chpl_mem_free(memAlloc, lineno, filename);
+    return;
+  }
+
+  cls = &cache->classes[size_to_class(size)];
+
+  chpl_memhook_free_pre(memAlloc, lineno, filename);
+  if (cls->len < POOL_MAX_FREE) {
+    ((pool_obj_t*) memAlloc)->next = cls->head;
+    cls->head = (pool_obj_t*) memAlloc;
+    cls->len++;
+  } else {
+    chpl_free(memAlloc);
+    if (chpl_memTrack)
+      cls->heapFrees++;
+  }
+}
+
+
+//
+// The counters, like the rest of the memory statistics, only count
+// while memory tracking is on.  They are read while other threads may
+// be updating them, so the report is approximate unless the program is
+// quiescent.  Nothing is printed if the pools haven't been used.
+//
+void chpl_mem_pool_printStats(FILE* f) {
+  uint64_t poolAllocs[POOL_NUM_CLASSES] = { 0 };
+  uint64_t heapAllocs[POOL_NUM_CLASSES] = { 0 };
+  uint64_t heapFrees[POOL_NUM_CLASSES] = { 0 };
+  uint64_t total = 0;
+  pool_cache_t* cache;
+  int i;
+
+  for (cache = (pool_cache_t*) atomic_load_uintptr_t(&all_pool_caches);
+       cache != NULL;
+       cache = cache->next) {
+    for (i = 0; i < POOL_NUM_CLASSES; i++) {
+      poolAllocs[i] += cache->classes[i].poolAllocs;
+      heapAllocs[i] += cache->classes[i].heapAllocs;
+      heapFrees[i] += cache->classes[i].heapFrees;
+      total += cache->classes[i].poolAllocs + cache->classes[i].heapAllocs
+               + cache->classes[i].heapFrees;
+    }
+  }
+
+  if (total == 0)
+    return;
+
+  fprintf(f, "Runtime Object Pools\n");
+  fprintf(f, "Size       Pool Allocs    Heap Allocs    Heap Frees\n");
+  for (i = 0; i < POOL_NUM_CLASSES; i++) {
+    if (poolAllocs[i] + heapAllocs[i] + heapFrees[i] > 0)
+      fprintf(f, "%-9d  %-13" PRIu64 "  %-13" PRIu64 "  %" PRIu64 "\n",
+              1 << (i + POOL_MIN_LOG2),
+              poolAllocs[i], heapAllocs[i], heapFrees[i]);
+  }
+  fprintf(f, "==============================================================\n");
+}
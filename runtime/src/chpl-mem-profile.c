@@ -0,0 +1,366 @@
+/*
+ * Copyright 2004-2015 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "chplrt.h"
+#include "chpl-mem-profile.h"
+#include "chpl-comm.h"
+#include "chpl-mem-desc.h"
+#include "chpl-tasks.h"
+#include "chpl-thread-local-storage.h"
+#include "chpltimers.h"
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#undef malloc
+#undef calloc
+#undef free
+
+//
+// Each thread counts down the bytes it allocates, and the allocation
+// that takes the count to zero or below is sampled.  The countdown is
+// reset to a random value averaging the sampling interval, so that
+// programs that allocate in a regular pattern aren't sampled at the
+// same point in the pattern every time.  Each interval crossed stands
+// for sampleInterval bytes, so a site's estimate converges on the
+// number of bytes it allocated.
+//
+// Sampled allocations are kept in an address-keyed table so that their
+// frees can be charged back to their sites.  The table is large and
+// sparse, so most frees find their bucket empty and go no further.
+//
+#define SAMPLE_BUCKETS_LOG2 16
+#define NUM_SAMPLE_BUCKETS  (1 << SAMPLE_BUCKETS_LOG2)
+#define NUM_SAMPLE_LOCKS    32
+#define NUM_SITE_BUCKETS    1021
+
+typedef struct profileSite_struct {
+  chpl_mem_descInt_t description;
+  int32_t lineno;
+  c_string filename;
+  uint64_t samples;     // allocations sampled here
+  uint64_t allocBytes;  // estimated bytes allocated here
+  uint64_t liveBytes;   // estimated bytes allocated here and not freed
+  struct profileSite_struct* next;
+} profileSite;
+
+typedef struct profileSample_struct {
+  void* memAlloc;
+  profileSite* site;
+  uint64_t weight;      // bytes this sample stands for
+  struct profileSample_struct* next;
+} profileSample;
+
+typedef struct {
+  int64_t bytesLeft;    // until the next sample
+  uint64_t seed;
+} profileThread;
+
+chpl_bool chpl_memProfile = false;
+
+static uint64_t sampleInterval = 0;
+static double reportPeriod = 0;
+static double startTime;
+static double nextReport;
+static FILE* profileFile = NULL;
+
+CHPL_TLS_DECL(profileThread*, profile_thread);
+
+static profileSample* volatile sampleTable[NUM_SAMPLE_BUCKETS];
+static chpl_sync_aux_t sampleLocks[NUM_SAMPLE_LOCKS];
+
+static profileSite* siteTable[NUM_SITE_BUCKETS];
+static int numSites = 0;
+static chpl_sync_aux_t siteLock;
+
+
+static double profileNow(void) {
+  _timevalue t = chpl_now_timevalue();
+  return (double) chpl_timevalue_seconds(t)
+         + (double) chpl_timevalue_microseconds(t) / 1.0e6;
+}
+
+
+void chpl_mem_profile_init(size_t interval, size_t period, FILE* f) {
+  int i;
+
+  if (interval == 0)
+    return;
+
+  CHPL_TLS_INIT(profile_thread);
+  for (i = 0; i < NUM_SAMPLE_LOCKS; i++)
+    chpl_sync_initAux(&sampleLocks[i]);
+  chpl_sync_initAux(&siteLock);
+
+  sampleInterval = interval;
+  reportPeriod = (double) period;
+  startTime = profileNow();
+  nextReport = startTime + reportPeriod;
+  profileFile = f;
+  chpl_memProfile = true;
+}
+
+
+//
+// xorshift64*; the sampling points only need to be uncorrelated with
+// the program's allocation pattern.
+//
+static uint64_t nextInterval(profileThread* pt) {
+  pt->seed ^= pt->seed >> 12;
+  pt->seed ^= pt->seed << 25;
+  pt->seed ^= pt->seed >> 27;
+  return 1 + (pt->seed * UINT64_C(2685821657736338717)) % (2 * sampleInterval);
+}
+
+
+//
+// The first sampled allocation on each thread creates its state.  Like
+// the pool caches, thread states are never freed.
+//
+static profileThread* getProfileThread(void) {
+  profileThread* pt = (profileThread*) CHPL_TLS_GET(profile_thread);
+
+  if (pt != NULL)
+    return pt;
+
+  pt = (profileThread*) malloc(sizeof(profileThread));
+  if (pt == NULL)
+    return NULL;
+
+  pt->seed = ((uint64_t) (uintptr_t) pt) ^ UINT64_C(0x9e3779b97f4a7c15);
+  pt->bytesLeft = nextInterval(pt);
+  CHPL_TLS_SET(profile_thread, pt);
+  return pt;
+}
+
+
+static unsigned sampleBucket(void* memAlloc) {
+  return (unsigned) ((((uint64_t) (uintptr_t) memAlloc >> 4)
+                      * UINT64_C(0x9e3779b97f4a7c15))
+                     >> (64 - SAMPLE_BUCKETS_LOG2));
+}
+
+
+//
+// Returns the site for a description and source location, creating it
+// if need be.  The caller must hold siteLock.
+//
+static profileSite* getSite(chpl_mem_descInt_t description,
+                            int32_t lineno, c_string filename) {
+  unsigned bucket = ((unsigned) description * 31 + (unsigned) lineno)
+                    % NUM_SITE_BUCKETS;
+  profileSite* site;
+
+  for (site = siteTable[bucket]; site != NULL; site = site->next) {
+    if (site->description == description && site->lineno == lineno
+        && (site->filename == filename
+            || (site->filename && filename
+                && strcmp(site->filename, filename) == 0)))
+      return site;
+  }
+
+  site = (profileSite*) calloc(1, sizeof(profileSite));
+  if (site == NULL)
+    return NULL;
+  site->description = description;
+  site->lineno = lineno;
+  site->filename = filename;
+  site->next = siteTable[bucket];
+  siteTable[bucket] = site;
+  numSites++;
+  return site;
+}
+
+
+void chpl_mem_profile_malloc(void* memAlloc, size_t size,
+                             chpl_mem_descInt_t description,
+                             int32_t lineno, c_string filename) {
+  profileThread* pt;
+  profileSample* sample;
+  profileSite* site;
+  uint64_t weight = 0;
+  unsigned bucket;
+  chpl_bool reportDue = false;
+
+  if (memAlloc == NULL)
+    return;
+
+  pt = getProfileThread();
+  if (pt == NULL)
+    return;
+
+  pt->bytesLeft -= (int64_t) size;
+  if (pt->bytesLeft > 0)
+    return;
+
+  do {
+    weight += sampleInterval;
+    pt->bytesLeft += nextInterval(pt);
+  } while (pt->bytesLeft <= 0);
+
+  sample = (profileSample*) malloc(sizeof(profileSample));
+  if (sample == NULL)
+    return;
+
+  chpl_sync_lock(&siteLock);
+  site = getSite(description, lineno, filename);
+  if (site != NULL) {
+    site->samples++;
+    site->allocBytes += weight;
+    site->liveBytes += weight;
+  }
+  if (reportPeriod > 0) {
+    double now = profileNow();
+    if (now >= nextReport) {
+      nextReport = now + reportPeriod;
+      reportDue = true;
+    }
+  }
+  chpl_sync_unlock(&siteLock);
+
+  if (site == NULL) {
+    free(sample);
+  } else {
+    sample->memAlloc = memAlloc;
+    sample->site = site;
+    sample->weight = weight;
+
+    bucket = sampleBucket(memAlloc);
+    chpl_sync_lock(&sampleLocks[bucket % NUM_SAMPLE_LOCKS]);
+    sample->next = sampleTable[bucket];
+    sampleTable[bucket] = sample;
+    chpl_sync_unlock(&sampleLocks[bucket % NUM_SAMPLE_LOCKS]);
+  }
+
+  if (reportDue)
+    chpl_mem_profile_print();
+}
+
+
+void chpl_mem_profile_free(void* memAlloc) {
+  profileSample* sample;
+  profileSample** prev;
+  unsigned bucket;
+
+  if (memAlloc == NULL)
+    return;
+
+  //
+  // Checking for an empty bucket doesn't need the lock.  If memAlloc
+  // was sampled, its sample went into the table before the allocation
+  // returned, so whoever is freeing it can see the sample.
+  //
+  bucket = sampleBucket(memAlloc);
+  if (sampleTable[bucket] == NULL)
+    return;
+
+  chpl_sync_lock(&sampleLocks[bucket % NUM_SAMPLE_LOCKS]);
+  for (prev = (profileSample**) &sampleTable[bucket], sample = *prev;
+       sample != NULL && sample->memAlloc != memAlloc;
+       prev = &sample->next, sample = *prev)
+    ;
+  if (sample != NULL)
+    *prev = sample->next;
+  chpl_sync_unlock(&sampleLocks[bucket % NUM_SAMPLE_LOCKS]);
+
+  if (sample != NULL) {
+    chpl_sync_lock(&siteLock);
+    sample->site->liveBytes -= sample->weight;
+    chpl_sync_unlock(&siteLock);
+    free(sample);
+  }
+}
+
+
+static int siteCmp(const void* p1, const void* p2) {
+  const profileSite* s1 = *(profileSite* const*) p1;
+  const profileSite* s2 = *(profileSite* const*) p2;
+
+  if (s1->liveBytes != s2->liveBytes)
+    return (s1->liveBytes < s2->liveBytes) ? 1 : -1;
+  if (s1->allocBytes != s2->allocBytes)
+    return (s1->allocBytes < s2->allocBytes) ? 1 : -1;
+  return 0;
+}
+
+
+//
+// Sites are listed by estimated live memory, largest first, so that
+// whatever is growing shows up at the top.  The rate is averaged over
+// the whole run so far.
+//
+void chpl_mem_profile_print(void) {
+  const int numberWidth = 13;
+  profileSite** sites;
+  profileSite* site;
+  double elapsed;
+  int i, n = 0;
+
+  if (!chpl_memProfile)
+    return;
+
+  chpl_sync_lock(&siteLock);
+
+  elapsed = profileNow() - startTime;
+  if (elapsed <= 0)
+    elapsed = 1e-6;
+
+  sites = (profileSite**) malloc((numSites + 1) * sizeof(profileSite*));
+  if (sites == NULL) {
+    chpl_sync_unlock(&siteLock);
+    return;
+  }
+  for (i = 0; i < NUM_SITE_BUCKETS; i++)
+    for (site = siteTable[i]; site != NULL; site = site->next)
+      sites[n++] = site;
+  qsort(sites, n, sizeof(profileSite*), siteCmp);
+
+  fprintf(profileFile, "=====================\n");
+  if (chpl_numNodes > 1)
+    fprintf(profileFile, "Memory Profile Report (locale %" FORMAT_c_nodeid_t
+            ")\n", chpl_nodeID);
+  else
+    fprintf(profileFile, "Memory Profile Report\n");
+  fprintf(profileFile, "==============================================================\n");
+  fprintf(profileFile, "Sampling interval: %" PRIu64 " bytes\n", sampleInterval);
+  fprintf(profileFile, "Elapsed time: %.3f seconds\n", elapsed);
+  fprintf(profileFile, "==============================================================\n");
+  fprintf(profileFile, "Estimated live memory (bytes)\n");
+  fprintf(profileFile, "               Estimated allocation rate (bytes/sec)\n");
+  fprintf(profileFile, "                              Number of samples\n");
+  fprintf(profileFile, "                                             Allocated at (Description)\n");
+  fprintf(profileFile, "==============================================================\n");
+  for (i = 0; i < n; i++) {
+    site = sites[i];
+    fprintf(profileFile, "%-*" PRIu64 "  %-*.0f  %-*" PRIu64 "  %s:%" PRId32
+            " (%s)\n",
+            numberWidth, site->liveBytes,
+            numberWidth, site->allocBytes / elapsed,
+            numberWidth, site->samples,
+            (site->filename ? site->filename : "--"), site->lineno,
+            chpl_mem_descString(site->description));
+  }
+  fprintf(profileFile, "==============================================================\n");
+  fflush(profileFile);
+
+  chpl_sync_unlock(&siteLock);
+
+  free(sites);
+}
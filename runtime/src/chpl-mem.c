@@ -23,6 +23,7 @@
 #include "chplrt.h"
 
 #include "chpl-mem.h"
+#include "chpl-mem-pool.h"
 #include "chpltypes.h"
 #include "error.h"
 
@@ -32,6 +33,7 @@ static int heapInitialized = 0;
 
 void chpl_mem_init(void) {
   chpl_mem_layerInit();
+  chpl_mem_pool_init();
   heapInitialized = 1;
 }
 
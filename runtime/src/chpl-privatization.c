@@ -19,49 +19,92 @@
 
 #include "chplrt.h"
 #include "chpl-privatization.h"
+#include "chpl-atomics.h"
+#include "chpl-bitops.h"
 #include "chpl-mem.h"
-#include "chpl-tasks.h"
+#include "error.h"
 
-static int64_t chpl_capPrivateObjects = 0;
-static chpl_sync_aux_t privatizationSync;
+//
+// The privatized object table is a sequence of segments, each twice the
+// size of the one before it.  Segments are never moved or copied once
+// they are allocated, so a reader only has to find the segment for a
+// pid and index into it, with no locking.  A segment is allocated by the
+// first call that needs it and published with a compare-and-swap; if two
+// calls race, the loser frees its copy and uses the winner's.
+//
+// Pids handed out by the modules are dense, so with a first segment of
+// 2^PRIV_SEG0_LOG2 entries segment k holds pids
+// [2^PRIV_SEG0_LOG2 * (2^k - 1), 2^PRIV_SEG0_LOG2 * (2^(k+1) - 1)).
+//
+#define PRIV_SEG0_LOG2 6
+#define PRIV_NUM_SEGS  48
 
-void** chpl_privateObjects;
+static atomic_uintptr_t chpl_privateObjectSegs[PRIV_NUM_SEGS];
 
-void chpl_privatization_init(void) {
-    chpl_sync_initAux(&privatizationSync);
+static inline void pidToSeg(int64_t pid, int* seg, int64_t* off) {
+  uint64_t n = (uint64_t) pid + (1 << PRIV_SEG0_LOG2);
+  int msb = 63 - (int) chpl_bitops_clz_64(n);
+
+  *seg = msb - PRIV_SEG0_LOG2;
+  *off = (int64_t) (n - ((uint64_t) 1 << msb));
 }
 
-void chpl_newPrivatizedClass(void* v, int64_t pid) {
-  // We need to lock around this operation so two calls in rapid succession
-  // that pass the chpl_capPrivateObjects limit don't both try to create a new
-  // array. If they do, one of the calls will be leaked and an invalid pointer
-  // to be placed in the table.
-  chpl_sync_lock(&privatizationSync);
-
-  pid += 1;
-  if (pid == 1) {
-    chpl_capPrivateObjects = 8;
+static void** getSeg(int seg) {
+  uintptr_t cur = atomic_load_uintptr_t(&chpl_privateObjectSegs[seg]);
+
+  if (cur == 0) {
+    size_t size = (size_t) 1 << (seg + PRIV_SEG0_LOG2);
     // "private" means "node-private", so we can use the system allocator.
-    chpl_privateObjects = chpl_mem_allocMany(chpl_capPrivateObjects, sizeof(void*), CHPL_RT_MD_COMM_PRIVATE_OBJECTS_ARRAY, 0, "");
-  } else {
-    if (pid > chpl_capPrivateObjects) {
-      void** tmp;
-      chpl_capPrivateObjects *= 2;
-      tmp = chpl_mem_allocMany(chpl_capPrivateObjects, sizeof(void*), CHPL_RT_MD_COMM_PRIVATE_OBJECTS_ARRAY, 0, "");
-      chpl_memcpy((void*)tmp, (void*)chpl_privateObjects, (pid-1)*sizeof(void*));
-      chpl_privateObjects = tmp;
-      // purposely leak old copies of chpl_privateObject to avoid the need to
-      // lock chpl_getPrivatizedClass; TODO: fix with lock free data structure
+    void** tmp = chpl_mem_allocManyZero(size, sizeof(void*),
+                                        CHPL_RT_MD_COMM_PRIVATE_OBJECTS_ARRAY,
+                                        0, "");
+    if (atomic_compare_exchange_strong_uintptr_t(&chpl_privateObjectSegs[seg],
+                                                 0, (uintptr_t) tmp))
+      cur = (uintptr_t) tmp;
+    else {
+      chpl_mem_free(tmp, 0, "");
+      cur = atomic_load_uintptr_t(&chpl_privateObjectSegs[seg]);
     }
   }
-  chpl_privateObjects[pid-1] = v;
 
-  chpl_sync_unlock(&privatizationSync);
+  return (void**) cur;
 }
 
+void chpl_privatization_init(void) {
+  int i;
 
-extern void* chpl_getPrivatizedClass(int64_t i) {
-  return chpl_privateObjects[i];
+  for (i = 0; i < PRIV_NUM_SEGS; i++)
+    atomic_init_uintptr_t(&chpl_privateObjectSegs[i], 0);
 }
 
+void chpl_newPrivatizedClass(void* v, int64_t pid) {
+  int     seg;
+  int64_t off;
+
+  pidToSeg(pid, &seg, &off);
+  if (seg >= PRIV_NUM_SEGS)
+    chpl_internal_error("too many privatized objects");
+  getSeg(seg)[off] = v;
+}
 
+
+//
+// Drop the object for a pid whose distributed object has been destroyed,
+// so the pid can be handed out again.
+//
+void chpl_clearPrivatizedClass(int64_t pid) {
+  int     seg;
+  int64_t off;
+
+  pidToSeg(pid, &seg, &off);
+  getSeg(seg)[off] = NULL;
+}
+
+
+extern void* chpl_getPrivatizedClass(int64_t i) {
+  int     seg;
+  int64_t off;
+
+  pidToSeg(i, &seg, &off);
+  return ((void**) atomic_load_uintptr_t(&chpl_privateObjectSegs[seg]))[off];
+}
@@ -20,8 +20,11 @@
 #include "chplrt.h"
 
 #include "chplmemtrack.h"
+#include "chpl-atomics.h"
 #include "chpl-mem.h"
 #include "chpl-mem-desc.h"
+#include "chpl-mem-pool.h"
+#include "chpl-mem-profile.h"
 #include "chpl-tasks.h"
 #include "chpltypes.h"
 #include "chpl-comm.h"
@@ -48,6 +51,8 @@ extern void chpl_memTracking_returnConfigVals(chpl_bool*,
                                               chpl_bool*,
                                               size_t*,
                                               size_t*,
+                                              size_t*,
+                                              size_t*,
                                               c_string*,
                                               c_string*);
 
@@ -67,33 +72,56 @@ typedef struct memTableEntry_struct { /* table entry */
   struct memTableEntry_struct* nextInBucket;
 } memTableEntry;
 
-#define NUM_HASH_SIZE_INDICES 20
+#define NUM_HASH_SIZE_INDICES 24
 
-static int hashSizes[NUM_HASH_SIZE_INDICES] = { 1543, 3079, 6151, 12289, 24593, 49157, 98317,
+static int hashSizes[NUM_HASH_SIZE_INDICES] = { 97, 193, 389, 769,
+                                                1543, 3079, 6151, 12289, 24593, 49157, 98317,
                                                 196613, 393241, 786433, 1572869, 3145739,
                                                 6291469, 12582917, 25165843, 50331653,
                                                 100663319, 201326611, 402653189, 805306457 };
-static int hashSizeIndex = 0;
-static int hashSize = 0;
 
-static memTableEntry** memTable = NULL;
+//
+// The table of tracked allocations is split into shards by address,
+// each with its own lock, hash table, and allocated/freed counters, so
+// that tasks allocating and freeing different memory don't contend.
+// The current and maximum totals are atomics, since the memory limit
+// and the high-water mark are about the whole locale.  Reports lock
+// the shards and add them up, so they are as exact as before.
+//
+#define NUM_MEM_TABLE_SHARDS 32
+
+typedef struct {
+  chpl_sync_aux_t lock;
+  memTableEntry** table;
+  int hashSizeIndex;
+  int hashSize;
+  size_t entries;         /* number of entries in this shard's table */
+  size_t allocated;       /* memory allocated, counted in this shard */
+  size_t freed;           /* memory freed, counted in this shard */
+} memTableShard;
+
+static memTableShard memTableShards[NUM_MEM_TABLE_SHARDS];
 
 static _Bool memLeaks = false;
 static _Bool memLeaksTable = false;
 static _Bool memStats = false;
 static size_t memMax = 0;
 static size_t memThreshold = 0;
+static size_t memProfile = 0;
+static size_t memProfilePeriod = 0;
 static c_string memLog = "";
 static FILE* memLogFile = NULL;
 static c_string memLeaksLog = "";
 
-static size_t totalMem = 0;       /* total memory currently allocated */
-static size_t maxMem = 0;         /* maximum total memory during run  */
-static size_t totalAllocated = 0; /* total memory allocated */
-static size_t totalFreed = 0;     /* total memory freed */
-static size_t totalEntries = 0;     /* number of entries in hash table */
+//
+// chpl_printMemStat() reads these directly from other locales, so for
+// multi-locale reports they have to be plain integers underneath, as
+// they are with intrinsic atomics.
+//
+static atomic_uint_least64_t totalMem; /* total memory currently allocated */
+static atomic_uint_least64_t maxMem;   /* maximum total memory during run  */
 
-static chpl_sync_aux_t memTrack_sync;
+static chpl_sync_aux_t memTrack_sync;  /* serializes the reports */
 
 
 void chpl_setMemFlags(void) {
@@ -120,6 +148,8 @@ void chpl_setMemFlags(void) {
                                     &memLeaksTable,
                                     &memMax,
                                     &memThreshold,
+                                    &memProfile,
+                                    &memProfilePeriod,
                                     &memLog,
                                     &memLeaksLog);
 
@@ -146,11 +176,22 @@ void chpl_setMemFlags(void) {
   }
 
   if (chpl_memTrack) {
+    int i;
+
     chpl_sync_initAux(&memTrack_sync);
-    hashSizeIndex = 0;
-    hashSize = hashSizes[hashSizeIndex];
-    memTable = calloc(hashSize, sizeof(memTableEntry*));
+    atomic_init_uint_least64_t(&totalMem, 0);
+    atomic_init_uint_least64_t(&maxMem, 0);
+    for (i = 0; i < NUM_MEM_TABLE_SHARDS; i++) {
+      memTableShard* shard = &memTableShards[i];
+
+      chpl_sync_initAux(&shard->lock);
+      shard->hashSizeIndex = 0;
+      shard->hashSize = hashSizes[shard->hashSizeIndex];
+      shard->table = calloc(shard->hashSize, sizeof(memTableEntry*));
+    }
   }
+
+  chpl_mem_profile_init(memProfile, memProfilePeriod, memLogFile);
 }
 
 
@@ -166,37 +207,68 @@ static unsigned hash(void* memAlloc, int hashSize) {
 }
 
 
+//
+// Allocations are at least 16-byte aligned, so skip the low bits.
+//
+static memTableShard* getShard(void* memAlloc) {
+  return &memTableShards[((uintptr_t) memAlloc >> 4) % NUM_MEM_TABLE_SHARDS];
+}
+
+
+static void lockAllShards(void) {
+  int i;
+  for (i = 0; i < NUM_MEM_TABLE_SHARDS; i++)
+    chpl_sync_lock(&memTableShards[i].lock);
+}
+
+
+static void unlockAllShards(void) {
+  int i;
+  for (i = 0; i < NUM_MEM_TABLE_SHARDS; i++)
+    chpl_sync_unlock(&memTableShards[i].lock);
+}
+
+
+//
+// This is called after the shard lock is released, so that the error
+// for exceeding the memory limit doesn't leave the shard locked for
+// the exit-time reports.
+//
 static void increaseMemStat(size_t chunk, int32_t lineno, c_string filename) {
-  totalMem += chunk;
-  totalAllocated += chunk;
-  if (memMax && (totalMem > memMax)) {
+  uint_least64_t newTotal = atomic_fetch_add_uint_least64_t(&totalMem, chunk)
+                            + chunk;
+  uint_least64_t max = atomic_load_uint_least64_t(&maxMem);
+
+  while (newTotal > max
+         && !atomic_compare_exchange_strong_uint_least64_t(&maxMem, max,
+                                                           newTotal))
+    max = atomic_load_uint_least64_t(&maxMem);
+
+  if (memMax && (newTotal > memMax)) {
     chpl_error("Exceeded memory limit", lineno, filename);
   }
-  if (totalMem > maxMem)
-    maxMem = totalMem;
 }
 
 
 static void decreaseMemStat(size_t chunk) {
-  totalMem -= chunk; // > totalMem ? 0 : totalMem - chunk;
-  totalFreed += chunk;
+  (void) atomic_fetch_sub_uint_least64_t(&totalMem, chunk);
 }
 
 
 static void
-resizeTable(int direction) {
+resizeTable(memTableShard* shard, int direction) {
   memTableEntry** newMemTable = NULL;
   int newHashSizeIndex, newHashSize, newHashValue;
   int i;
   memTableEntry* me;
   memTableEntry* next;
 
-  newHashSizeIndex = hashSizeIndex + direction;
+  newHashSizeIndex = shard->hashSizeIndex + direction;
   newHashSize = hashSizes[newHashSizeIndex];
   newMemTable = calloc(newHashSize, sizeof(memTableEntry*));
 
-  for (i = 0; i < hashSize; i++) {
-    for (me = memTable[i]; me != NULL; me = next) {
+  for (i = 0; i < shard->hashSize; i++) {
+    for (me = shard->table[i]; me != NULL; me = next) {
       next = me->nextInBucket;
       newHashValue = hash(me->memAlloc, newHashSize);
       me->nextInBucket = newMemTable[newHashValue];
@@ -204,19 +276,20 @@ resizeTable(int direction) {
     }
   }
 
-  free(memTable);
-  memTable = newMemTable;
-  hashSize = newHashSize;
-  hashSizeIndex = newHashSizeIndex;
+  free(shard->table);
+  shard->table = newMemTable;
+  shard->hashSize = newHashSize;
+  shard->hashSizeIndex = newHashSizeIndex;
 }
 
 
-static void addMemTableEntry(void* memAlloc, size_t number, size_t size, chpl_mem_descInt_t description, int32_t lineno, c_string filename) {
+static void addMemTableEntry(memTableShard* shard, void* memAlloc, size_t number, size_t size, chpl_mem_descInt_t description, int32_t lineno, c_string filename) {
   unsigned hashValue;
   memTableEntry* memEntry;
 
-  if ((totalEntries+1)*2 > hashSize && hashSizeIndex < NUM_HASH_SIZE_INDICES-1)
-    resizeTable(1);
+  if ((shard->entries+1)*2 > shard->hashSize
+      && shard->hashSizeIndex < NUM_HASH_SIZE_INDICES-1)
+    resizeTable(shard, 1);
 
   memEntry = (memTableEntry*) calloc(1, sizeof(memTableEntry));
   if (!memEntry) {
@@ -224,33 +297,33 @@ static void addMemTableEntry(void* memAlloc, size_t number, size_t size, chpl_me
                lineno, filename);
   }
 
-  hashValue = hash(memAlloc, hashSize);
-  memEntry->nextInBucket = memTable[hashValue];
-  memTable[hashValue] = memEntry;
+  hashValue = hash(memAlloc, shard->hashSize);
+  memEntry->nextInBucket = shard->table[hashValue];
+  shard->table[hashValue] = memEntry;
   memEntry->description = description;
   memEntry->memAlloc = memAlloc;
   memEntry->lineno = lineno;
   memEntry->filename = filename; // do we want to copy this string?
   memEntry->number = number;
   memEntry->size = size;
-  increaseMemStat(number*size, lineno, filename);
-  totalEntries += 1;
+  shard->allocated += number*size;
+  shard->entries += 1;
 }
 
 
-static memTableEntry* removeMemTableEntry(void* address) {
-  unsigned hashValue = hash(address, hashSize);
-  memTableEntry* thisBucketEntry = memTable[hashValue];
+static memTableEntry* removeMemTableEntry(memTableShard* shard, void* address) {
+  unsigned hashValue = hash(address, shard->hashSize);
+  memTableEntry* thisBucketEntry = shard->table[hashValue];
   memTableEntry* deletedBucket = NULL;
 
   if (!thisBucketEntry)
     return NULL;
 
   if (thisBucketEntry->memAlloc == address) {
-    memTable[hashValue] = thisBucketEntry->nextInBucket;
+    shard->table[hashValue] = thisBucketEntry->nextInBucket;
     deletedBucket = thisBucketEntry;
   } else {
-    for (thisBucketEntry = memTable[hashValue];
+    for (thisBucketEntry = shard->table[hashValue];
          thisBucketEntry != NULL;
          thisBucketEntry = thisBucketEntry->nextInBucket) {
 
@@ -263,20 +336,49 @@ static memTableEntry* removeMemTableEntry(void* address) {
     }
   }
   if (deletedBucket) {
-    decreaseMemStat(deletedBucket->number * deletedBucket->size);
-    totalEntries -= 1;
-    if (totalEntries*8 < hashSize && hashSizeIndex > 0)
-      resizeTable(-1);
+    shard->freed += deletedBucket->number * deletedBucket->size;
+    shard->entries -= 1;
+    if (shard->entries*8 < shard->hashSize && shard->hashSizeIndex > 0)
+      resizeTable(shard, -1);
   }
   return deletedBucket;
 }
 
 
+//
+// Add up the shards' counters on the given locale.  Remote shards are
+// read without their locks, as the totals always have been.
+//
+static void sumMemStats(c_nodeid_t node, size_t* allocated, size_t* freed,
+                        int32_t lineno, c_string filename) {
+  int i;
+
+  *allocated = 0;
+  *freed = 0;
+  for (i = 0; i < NUM_MEM_TABLE_SHARDS; i++) {
+    memTableShard* shard = &memTableShards[i];
+
+    if (node == chpl_nodeID) {
+      chpl_sync_lock(&shard->lock);
+      *allocated += shard->allocated;
+      *freed += shard->freed;
+      chpl_sync_unlock(&shard->lock);
+    } else {
+      size_t a, f;
+      chpl_gen_comm_get(&a, node, &shard->allocated, sizeof(size_t), -1 /* broke for hetero */, 1, lineno, filename);
+      chpl_gen_comm_get(&f, node, &shard->freed, sizeof(size_t), -1 /* broke for hetero */, 1, lineno, filename);
+      *allocated += a;
+      *freed += f;
+    }
+  }
+}
+
+
 uint64_t chpl_memoryUsed(int32_t lineno, c_string filename) {
   if (!chpl_memTrack)
     chpl_error("invalid call to memoryUsed(); rerun with --memTrack",
                lineno, filename);
-  return (uint64_t)totalMem;
+  return (uint64_t)atomic_load_uint_least64_t(&totalMem);
 }
 
 
@@ -288,9 +390,13 @@ void chpl_printMemStat(int32_t lineno, c_string filename) {
   fprintf(memLogFile, "=================\n");
   fprintf(memLogFile, "Memory Statistics\n");
   if (chpl_numNodes == 1) {
+    size_t totalAllocated, totalFreed;
+    sumMemStats(chpl_nodeID, &totalAllocated, &totalFreed, lineno, filename);
     fprintf(memLogFile, "==============================================================\n");
-    fprintf(memLogFile, "Current Allocated Memory               %zd\n", totalMem);
-    fprintf(memLogFile, "Maximum Simultaneous Allocated Memory  %zd\n", maxMem);
+    fprintf(memLogFile, "Current Allocated Memory               %zd\n",
+            (size_t) atomic_load_uint_least64_t(&totalMem));
+    fprintf(memLogFile, "Maximum Simultaneous Allocated Memory  %zd\n",
+            (size_t) atomic_load_uint_least64_t(&maxMem));
     fprintf(memLogFile, "Total Allocated Memory                 %zd\n", totalAllocated);
     fprintf(memLogFile, "Total Freed Memory                     %zd\n", totalFreed);
     fprintf(memLogFile, "==============================================================\n");
@@ -304,15 +410,16 @@ void chpl_printMemStat(int32_t lineno, c_string filename) {
     fprintf(memLogFile, "                                            Total Freed Memory\n");
     fprintf(memLogFile, "==============================================================\n");
     for (i = 0; i < chpl_numNodes; i++) {
-      static size_t m1, m2, m3, m4;
-      chpl_gen_comm_get(&m1, i, &totalMem, sizeof(size_t), -1 /* broke for hetero */, 1, lineno, filename);
-      chpl_gen_comm_get(&m2, i, &maxMem, sizeof(size_t), -1 /* broke for hetero */, 1, lineno, filename);
-      chpl_gen_comm_get(&m3, i, &totalAllocated,  sizeof(size_t), -1 /* broke for hetero */, 1, lineno, filename);
-      chpl_gen_comm_get(&m4, i, &totalFreed, sizeof(size_t), -1 /*broke for hetero */, 1, lineno, filename);
-      fprintf(memLogFile, "%-9d  %-9zu  %-9zu  %-9zu  %-9zu\n", i, m1, m2, m3, m4);
+      static uint_least64_t m1, m2;
+      static size_t m3, m4;
+      chpl_gen_comm_get(&m1, i, &totalMem, sizeof(uint_least64_t), -1 /* broke for hetero */, 1, lineno, filename);
+      chpl_gen_comm_get(&m2, i, &maxMem, sizeof(uint_least64_t), -1 /* broke for hetero */, 1, lineno, filename);
+      sumMemStats(i, &m3, &m4, lineno, filename);
+      fprintf(memLogFile, "%-9d  %-9zu  %-9zu  %-9zu  %-9zu\n", i, (size_t) m1, (size_t) m2, m3, m4);
     }
     fprintf(memLogFile, "==============================================================\n");
   }
+  chpl_mem_pool_printStats(memLogFile);
   chpl_sync_unlock(&memTrack_sync);
 }
 
@@ -324,19 +431,24 @@ static int leakedMemTableEntryCmp(const void* p1, const void* p2) {
 void chpl_printLeakedMemTable(void) {
   size_t* table;
   memTableEntry* me;
-  int i;
+  int s, i;
   const int numberWidth   = 9;
   const int numEntries = CHPL_RT_MD_NUM+chpl_mem_numDescs;
 
   table = (size_t*)calloc(numEntries, 3*sizeof(size_t));
 
-  for (i = 0; i < hashSize; i++) {
-    for (me = memTable[i]; me != NULL; me = me->nextInBucket) {
-      table[3*me->description] += me->number*me->size;
-      table[3*me->description+1] += 1;
-      table[3*me->description+2] = me->description;
+  lockAllShards();
+  for (s = 0; s < NUM_MEM_TABLE_SHARDS; s++) {
+    memTableShard* shard = &memTableShards[s];
+    for (i = 0; i < shard->hashSize; i++) {
+      for (me = shard->table[i]; me != NULL; me = me->nextInBucket) {
+        table[3*me->description] += me->number*me->size;
+        table[3*me->description+1] += 1;
+        table[3*me->description+2] = me->description;
+      }
     }
   }
+  unlockAllShards();
 
   qsort(table, numEntries, 3*sizeof(size_t), leakedMemTableEntryCmp);
 
@@ -374,6 +486,12 @@ void chpl_reportMemInfo() {
     fprintf(memLogFile, "\n");
     chpl_printMemTable(0, 0, 0);
   }
+  if (chpl_memProfile) {
+    fprintf(memLogFile, "\n");
+    chpl_mem_profile_print();
+    // No periodic reports after the log file is closed.
+    chpl_memProfile = false;
+  }
   if (memLogFile && memLogFile != stdout)
     fclose(memLogFile);
   if (memLeaksLog && strcmp(memLeaksLog, "")) {
@@ -410,24 +528,32 @@ void chpl_printMemTable(int64_t threshold, int32_t lineno, c_string filename) {
   int totalWidth;
 
   memTableEntry* memEntry;
-  int n, i;
+  int n, s, i;
   char* loc;
   memTableEntry** table;
 
   if (!chpl_memTrack)
     chpl_error("The printMemTable function only works with the --memTrack flag", lineno, filename);
 
+  //
+  // Hold all the shards while we print, so the table is a snapshot.
+  //
+  lockAllShards();
+
   n = 0;
   filenameWidth = strlen("Allocated Memory (Bytes)");
-  for (i = 0; i < hashSize; i++) {
-    for (memEntry = memTable[i]; memEntry != NULL; memEntry = memEntry->nextInBucket) {
-      size_t chunk = memEntry->number * memEntry->size;
-      if (chunk >= threshold) {
-        n += 1;
-        if (memEntry->filename) {
-          int filenameLength = strlen(memEntry->filename);
-          if (filenameLength > filenameWidth)
-            filenameWidth = filenameLength;
+  for (s = 0; s < NUM_MEM_TABLE_SHARDS; s++) {
+    memTableShard* shard = &memTableShards[s];
+    for (i = 0; i < shard->hashSize; i++) {
+      for (memEntry = shard->table[i]; memEntry != NULL; memEntry = memEntry->nextInBucket) {
+        size_t chunk = memEntry->number * memEntry->size;
+        if (chunk >= threshold) {
+          n += 1;
+          if (memEntry->filename) {
+            int filenameLength = strlen(memEntry->filename);
+            if (filenameLength > filenameWidth)
+              filenameWidth = filenameLength;
+          }
         }
       }
     }
@@ -449,15 +575,20 @@ void chpl_printMemTable(int64_t threshold, int32_t lineno, c_string filename) {
   fprintf(memLogFile, "\n");
 
   table = (memTableEntry**)malloc(n*sizeof(memTableEntry*));
-  if (!table)
+  if (!table) {
+    unlockAllShards();
     chpl_error("out of memory printing memory table", lineno, filename);
+  }
 
   n = 0;
-  for (i = 0; i < hashSize; i++) {
-    for (memEntry = memTable[i]; memEntry != NULL; memEntry = memEntry->nextInBucket) {
-      size_t chunk = memEntry->number * memEntry->size;
-      if (chunk >= threshold) {
-        table[n++] = memEntry;
+  for (s = 0; s < NUM_MEM_TABLE_SHARDS; s++) {
+    memTableShard* shard = &memTableShards[s];
+    for (i = 0; i < shard->hashSize; i++) {
+      for (memEntry = shard->table[i]; memEntry != NULL; memEntry = memEntry->nextInBucket) {
+        size_t chunk = memEntry->number * memEntry->size;
+        if (chunk >= threshold) {
+          table[n++] = memEntry;
+        }
       }
     }
   }
@@ -484,6 +615,8 @@ void chpl_printMemTable(int64_t threshold, int32_t lineno, c_string filename) {
   fprintf(memLogFile, "\n");
   putchar('\n');
 
+  unlockAllShards();
+
   free(table);
   free(loc);
 }
@@ -494,9 +627,11 @@ void chpl_track_malloc(void* memAlloc, size_t number, size_t size,
                        int32_t lineno, c_string filename) {
   if (number * size > memThreshold) {
     if (chpl_memTrack) {
-      chpl_sync_lock(&memTrack_sync);
-      addMemTableEntry(memAlloc, number, size, description, lineno, filename);
-      chpl_sync_unlock(&memTrack_sync);
+      memTableShard* shard = getShard(memAlloc);
+      chpl_sync_lock(&shard->lock);
+      addMemTableEntry(shard, memAlloc, number, size, description, lineno, filename);
+      chpl_sync_unlock(&shard->lock);
+      increaseMemStat(number*size, lineno, filename);
     }
     if (chpl_verbose_mem) {
       fprintf(memLogFile,
@@ -512,9 +647,11 @@ void chpl_track_malloc(void* memAlloc, size_t number, size_t size,
 void chpl_track_free(void* memAlloc, int32_t lineno, c_string filename) {
   memTableEntry* memEntry = NULL;
   if (chpl_memTrack) {
-    chpl_sync_lock(&memTrack_sync);
-    memEntry = removeMemTableEntry(memAlloc);
+    memTableShard* shard = getShard(memAlloc);
+    chpl_sync_lock(&shard->lock);
+    memEntry = removeMemTableEntry(shard, memAlloc);
     if (memEntry) {
+      decreaseMemStat(memEntry->number*memEntry->size);
       if (chpl_verbose_mem) {
         fprintf(memLogFile,
                 "%" FORMAT_c_nodeid_t ": %s:%" PRId32
@@ -525,7 +662,7 @@ void chpl_track_free(void* memAlloc, int32_t lineno, c_string filename) {
       }
       free(memEntry);
     }
-    chpl_sync_unlock(&memTrack_sync);
+    chpl_sync_unlock(&shard->lock);
   } else if (chpl_verbose_mem && !memEntry) {
     fprintf(memLogFile,
             "%" FORMAT_c_nodeid_t ": %s:%" PRId32 ": free at %p\n",
@@ -540,13 +677,16 @@ void chpl_track_realloc_pre(void* memAlloc, size_t size,
   memTableEntry* memEntry = NULL;
 
   if (chpl_memTrack && size > memThreshold) {
-    chpl_sync_lock(&memTrack_sync);
     if (memAlloc) {
-      memEntry = removeMemTableEntry(memAlloc);
-      if (memEntry)
+      memTableShard* shard = getShard(memAlloc);
+      chpl_sync_lock(&shard->lock);
+      memEntry = removeMemTableEntry(shard, memAlloc);
+      if (memEntry) {
+        decreaseMemStat(memEntry->number*memEntry->size);
         free(memEntry);
+      }
+      chpl_sync_unlock(&shard->lock);
     }
-    chpl_sync_unlock(&memTrack_sync);
   }
 }
 
@@ -557,9 +697,11 @@ void chpl_track_realloc_post(void* moreMemAlloc,
                          int32_t lineno, c_string filename) {
   if (size > memThreshold) {
     if (chpl_memTrack) {
-      chpl_sync_lock(&memTrack_sync);
-      addMemTableEntry(moreMemAlloc, 1, size, description, lineno, filename);
-      chpl_sync_unlock(&memTrack_sync);
+      memTableShard* shard = getShard(moreMemAlloc);
+      chpl_sync_lock(&shard->lock);
+      addMemTableEntry(shard, moreMemAlloc, 1, size, description, lineno, filename);
+      chpl_sync_unlock(&shard->lock);
+      increaseMemStat(size, lineno, filename);
     }
     if (chpl_verbose_mem) {
       fprintf(memLogFile,
@@ -60,6 +60,7 @@
 ssize_t qio_too_small_for_default_mmap = 16*1024;
 ssize_t qio_too_large_for_default_mmap = 64*1024*((size_t)1024*1024);
 ssize_t qio_mmap_chunk_iobufs = 128; // mmap 128 iobufs at a time (8M)
+ssize_t qio_readahead_iobufs = 128; // read ahead 128 iobufs (8M); 0 disables
 
 // Future - possibly set this based on ulimit?
 ssize_t qio_initial_mmap_max = 8*1024*1024;
@@ -2196,6 +2197,47 @@ qioerr _buffered_get_mmap(qio_channel_t* ch, int64_t amt_in, int writing)
   else return 0;
 }
 
+// Ask the OS to start reading the qio_readahead_iobufs iobufs past the
+// end of the channel's buffer, so that the next reads (or page faults,
+// for mmap) find the data in the page cache instead of waiting on the
+// disk.  The request doesn't block, so the I/O overlaps with whatever
+// the reader does with the data it already has.  It is only renewed
+// once the channel has consumed half of the window, to keep the number
+// of system calls down.  Errors are ignored; this is only advice.
+static
+void _buffered_read_ahead(qio_channel_t* ch)
+{
+#if (_XOPEN_SOURCE >= 600 || _POSIX_C_SOURCE >= 200112L)
+#ifdef POSIX_FADV_WILLNEED
+  qio_method_t method = (qio_method_t) (ch->hints & QIO_METHODMASK);
+  int64_t window;
+  int64_t start;
+  int64_t end;
+  int64_t ahead;
+
+  if( qio_readahead_iobufs <= 0 ) return;
+  if( ch->hints & (QIO_HINT_RANDOM | QIO_HINT_DIRECT) ) return;
+  // Only these methods read at file offsets matching channel offsets.
+  if( method != QIO_METHOD_PREADPWRITE && method != QIO_METHOD_MMAP ) return;
+  if( ch->file->fd == -1 ) return;
+
+  window = qio_readahead_iobufs * qbytes_iobuf_size;
+  start = ch->av_end;
+  end = ch->end_pos;
+  if( end - start > window ) end = start + window;
+
+  ahead = ch->readahead_end - start;
+  if( ahead >= window/2 ) return;
+  // Don't ask again for what the last request covered.
+  if( ahead > 0 ) start = ch->readahead_end;
+  if( end <= start ) return;
+
+  sys_posix_fadvise(ch->file->fd, start, end - start, POSIX_FADV_WILLNEED);
+  ch->readahead_end = end;
+#endif
+#endif
+}
+
 // Runs read or pread, whichever is appropriate,
 // to read into the buffer.
 static
@@ -2269,6 +2311,8 @@ qioerr _buffered_read_atleast(qio_channel_t* ch, int64_t amt)
 
   if( err ) return err;
 
+  _buffered_read_ahead(ch);
+
   if( return_eof ) return QIO_EEOF;
   else return 0;
 }
@@ -2544,6 +2588,7 @@ qioerr _qio_channel_require_unlocked(qio_channel_t* ch, int64_t amt, int writing
 
   if( (ch->hints & QIO_METHODMASK) == QIO_METHOD_MMAP ) {
     err = _buffered_get_mmap(ch, n_needed, writing);
+    if( !err && !writing ) _buffered_read_ahead(ch);
   } else if( (ch->hints & QIO_METHODMASK) == QIO_METHOD_MEMORY ) {
     err = _buffered_get_memory(ch, n_needed, writing);
   } else {
@@ -3348,6 +3393,110 @@ error:
   return err;
 }
 
+qioerr qio_channel_read_view(const int threadsafe, qio_channel_t* ch, uint8_t term, qbytes_t** bytes_out, uint8_t** ptr_out, int64_t* len_out)
+{
+  qioerr err;
+  qbuffer_iter_t start;
+  qbuffer_iter_t it;
+  qbuffer_iter_t end;
+  qbytes_t* bytes = NULL;
+  int64_t skip = 0;
+  int64_t len = 0;
+  int64_t searched = 0; // bytes after start known not to be term
+  int64_t avail;
+  void* found_at;
+  int found = 0;
+  int eof = 0;
+
+  *bytes_out = NULL;
+  *ptr_out = NULL;
+  *len_out = 0;
+
+  if( threadsafe ) {
+    err = qio_lock(&ch->lock);
+    if( err ) return err;
+  }
+
+  if( ! (ch->flags & QIO_FDFLAG_READABLE) ) {
+    QIO_GET_CONSTANT_ERROR(err, EBADF, "not readable");
+    goto error;
+  }
+
+  // handle channel position beyond end.
+  if( _right_mark_start(ch) > ch->end_pos ) {
+    err = QIO_EEOF;
+    goto error;
+  }
+
+  // Look for term in the available data, asking for more data
+  // each time we've searched all of it.
+  while( ! found && ! eof ) {
+    // (require calls advance_cached)
+    err = _qio_channel_require_unlocked(ch, searched + 1, 0);
+    if( qio_err_to_int(err) == EEOF ) err = 0;
+    if( err ) goto error;
+
+    avail = ch->av_end - _right_mark_start(ch);
+    if( avail <= searched ) eof = 1;
+
+    start = _right_mark_start_iter(ch);
+    end = _av_end_iter(ch);
+    it = start;
+    qbuffer_iter_advance(&ch->buf, &it, searched);
+    while( searched < avail ) {
+      qbuffer_iter_get(it, end, &bytes, &skip, &len);
+      found_at = memchr(VOID_PTR_ADD(bytes->data, skip), term, len);
+      if( found_at ) {
+        searched += VOID_PTR_DIFF(found_at, VOID_PTR_ADD(bytes->data, skip));
+        found = 1;
+        break;
+      }
+      searched += len;
+      qbuffer_iter_advance(&ch->buf, &it, len);
+    }
+  }
+
+  if( searched == 0 && ! found ) {
+    err = QIO_EEOF;
+    goto error;
+  }
+
+  // Return a view of the bytes if they are all in one part of the
+  // buffer, and otherwise copy them into new bytes.
+  start = _right_mark_start_iter(ch);
+  end = start;
+  qbuffer_iter_advance(&ch->buf, &end, searched);
+  qbuffer_iter_get(start, end, &bytes, &skip, &len);
+  if( len == searched ) {
+    qbytes_retain(bytes);
+  } else {
+    err = qbytes_create_calloc(&bytes, searched);
+    if( err ) goto error;
+    err = qbuffer_copyout(&ch->buf, start, end, bytes->data, searched);
+    if( err ) {
+      qbytes_release(bytes);
+      goto error;
+    }
+    skip = 0;
+  }
+
+  *bytes_out = bytes;
+  *ptr_out = (uint8_t*) VOID_PTR_ADD(bytes->data, skip);
+  *len_out = searched;
+
+  // Move past the bytes and the terminator, if there was one.
+  _set_right_mark_start(ch, start.offset + searched + found);
+  err = _qio_buffered_behind(ch, false);
+
+error:
+  _qio_channel_set_error_unlocked(ch, err);
+  if( threadsafe ) {
+    qio_unlock(&ch->lock);
+  }
+
+  return err;
+}
+
 qioerr qio_channel_mark_maybe_flush_bits(const int threadsafe, qio_channel_t* ch, int flushbits)
 {
   qioerr err;
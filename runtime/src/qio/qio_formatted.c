@@ -1885,6 +1885,98 @@ error:
   return err;
 }
 
+static const double _qio_double_pow10[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Converts a decimal number, as strtod would, when that can be done
+// exactly with a single floating point multiply or divide: when the
+// digits fit in 53 bits and the power of ten is exactly representable.
+// Returns the number of characters converted, or 0 if strtod is
+// needed. Leading spaces and a sign are accepted as strtod does;
+// inf, nan, and hexadecimal are left to strtod.
+static size_t _qio_strtod_fast(const char* restrict s, double* restrict out)
+{
+  const char* p = s;
+  uint64_t m = 0;
+  int ndigits = 0;
+  int any = 0;
+  int e10 = 0;
+  int negative = 0;
+  double v;
+
+  while( *p == ' ' ) p++;
+  if( *p == '+' ) p++;
+  else if( *p == '-' ) {
+    negative = 1;
+    p++;
+  }
+
+  for( ; *p >= '0' && *p <= '9'; p++ ) {
+    any = 1;
+    if( m == 0 && *p == '0' ) continue;
+    if( ++ndigits > 19 ) return 0;
+    m = 10 * m + (*p - '0');
+  }
+  if( *p == '.' ) {
+    p++;
+    for( ; *p >= '0' && *p <= '9'; p++ ) {
+      any = 1;
+      e10--;
+      if( m == 0 && *p == '0' ) continue;
+      if( ++ndigits > 19 ) return 0;
+      m = 10 * m + (*p - '0');
+    }
+  }
+  if( !any ) return 0;
+
+  if( *p == 'e' || *p == 'E' ) {
+    const char* q = p + 1;
+    int eneg = 0;
+    int ev = 0;
+    int edigits = 0;
+    if( *q == '+' ) q++;
+    else if( *q == '-' ) {
+      eneg = 1;
+      q++;
+    }
+    for( ; *q >= '0' && *q <= '9'; q++ ) {
+      if( ++edigits > 4 ) return 0;
+      ev = 10 * ev + (*q - '0');
+    }
+    // Like strtod, "1e" or "1e+" is just "1".
+    if( edigits > 0 ) {
+      e10 += eneg ? -ev : ev;
+      p = q;
+    }
+  }
+
+#if !defined(FLT_EVAL_METHOD) || FLT_EVAL_METHOD != 0
+  // With excess precision (e.g. x87) the multiply isn't correctly
+  // rounded to double, so it wouldn't match strtod.
+  return 0;
+#endif
+
+  if( m == 0 ) {
+    v = 0.0;
+  } else {
+    if( m > (UINT64_C(1) << 53) ) return 0;
+    // Move powers of ten into m while it stays exact.
+    while( e10 > 22 && m <= (UINT64_C(1) << 53) / 10 ) {
+      m *= 10;
+      e10--;
+    }
+    if( e10 < -22 || e10 > 22 ) return 0;
+    v = (double) m;
+    if( e10 < 0 ) v /= _qio_double_pow10[-e10];
+    else v *= _qio_double_pow10[e10];
+  }
+
+  *out = negative ? -v : v;
+  return p - s;
+}
+
 static
 qioerr qio_channel_scan_float_or_imag(const int threadsafe, qio_channel_t* restrict ch, void* restrict out, size_t len, bool imag)
 {
@@ -2022,8 +2114,15 @@ qioerr qio_channel_scan_float_or_imag(const int threadsafe, qio_channel_t* restr
   //printf("strtod on %s\n", buf);
 
   errno = 0;
-  // Now we have the number we're converting in buf. Read it.
-  num = strtod( buf, &end_conv);
+  // Now we have the number we're converting in buf. Read it,
+  // without strtod if the number is simple enough.
+  num = 0.0;
+  end_conv = buf;
+  if( st.gotbase == 10 ) {
+    size_t got = _qio_strtod_fast(buf, &num);
+    end_conv = buf + got;
+  }
+  if( end_conv == buf ) num = strtod( buf, &end_conv);
   if( num == 0 && end_conv == buf ) {
     // no conversion is performed.
     QIO_GET_CONSTANT_ERROR(err, EFORMAT, "not a floating point number");
@@ -2191,6 +2290,376 @@ int _ltoa(char* restrict dst, size_t size, uint64_t num, int isnegative,
   return i;
 }
 
+// Powers of ten for the fast float formatting path below: 10^k is
+// approximately f * 2^e, with f normalized so that its top bit is set
+// and rounded to nearest. Only every eighth power is in the table; the
+// ones in between are made by multiplying by an exact power of ten.
+typedef struct {
+  uint64_t f;
+  int e;
+} _qio_pow10_t;
+
+#define QIO_CACHED_POW10_MIN (-348)
+#define QIO_CACHED_POW10_STEP 8
+
+static const _qio_pow10_t _qio_cached_pow10[] = {
+  { UINT64_C(0xfa8fd5a0081c0288), -1220 }, // 1e-348
+  { UINT64_C(0xbaaee17fa23ebf76), -1193 }, // 1e-340
+  { UINT64_C(0x8b16fb203055ac76), -1166 }, // 1e-332
+  { UINT64_C(0xcf42894a5dce35ea), -1140 }, // 1e-324
+  { UINT64_C(0x9a6bb0aa55653b2d), -1113 }, // 1e-316
+  { UINT64_C(0xe61acf033d1a45df), -1087 }, // 1e-308
+  { UINT64_C(0xab70fe17c79ac6ca), -1060 }, // 1e-300
+  { UINT64_C(0xff77b1fcbebcdc4f), -1034 }, // 1e-292
+  { UINT64_C(0xbe5691ef416bd60c), -1007 }, // 1e-284
+  { UINT64_C(0x8dd01fad907ffc3c),  -980 }, // 1e-276
+  { UINT64_C(0xd3515c2831559a83),  -954 }, // 1e-268
+  { UINT64_C(0x9d71ac8fada6c9b5),  -927 }, // 1e-260
+  { UINT64_C(0xea9c227723ee8bcb),  -901 }, // 1e-252
+  { UINT64_C(0xaecc49914078536d),  -874 }, // 1e-244
+  { UINT64_C(0x823c12795db6ce57),  -847 }, // 1e-236
+  { UINT64_C(0xc21094364dfb5637),  -821 }, // 1e-228
+  { UINT64_C(0x9096ea6f3848984f),  -794 }, // 1e-220
+  { UINT64_C(0xd77485cb25823ac7),  -768 }, // 1e-212
+  { UINT64_C(0xa086cfcd97bf97f4),  -741 }, // 1e-204
+  { UINT64_C(0xef340a98172aace5),  -715 }, // 1e-196
+  { UINT64_C(0xb23867fb2a35b28e),  -688 }, // 1e-188
+  { UINT64_C(0x84c8d4dfd2c63f3b),  -661 }, // 1e-180
+  { UINT64_C(0xc5dd44271ad3cdba),  -635 }, // 1e-172
+  { UINT64_C(0x936b9fcebb25c996),  -608 }, // 1e-164
+  { UINT64_C(0xdbac6c247d62a584),  -582 }, // 1e-156
+  { UINT64_C(0xa3ab66580d5fdaf6),  -555 }, // 1e-148
+  { UINT64_C(0xf3e2f893dec3f126),  -529 }, // 1e-140
+  { UINT64_C(0xb5b5ada8aaff80b8),  -502 }, // 1e-132
+  { UINT64_C(0x87625f056c7c4a8b),  -475 }, // 1e-124
+  { UINT64_C(0xc9bcff6034c13053),  -449 }, // 1e-116
+  { UINT64_C(0x964e858c91ba2655),  -422 }, // 1e-108
+  { UINT64_C(0xdff9772470297ebd),  -396 }, // 1e-100
+  { UINT64_C(0xa6dfbd9fb8e5b88f),  -369 }, // 1e-92
+  { UINT64_C(0xf8a95fcf88747d94),  -343 }, // 1e-84
+  { UINT64_C(0xb94470938fa89bcf),  -316 }, // 1e-76
+  { UINT64_C(0x8a08f0f8bf0f156b),  -289 }, // 1e-68
+  { UINT64_C(0xcdb02555653131b6),  -263 }, // 1e-60
+  { UINT64_C(0x993fe2c6d07b7fac),  -236 }, // 1e-52
+  { UINT64_C(0xe45c10c42a2b3b06),  -210 }, // 1e-44
+  { UINT64_C(0xaa242499697392d3),  -183 }, // 1e-36
+  { UINT64_C(0xfd87b5f28300ca0e),  -157 }, // 1e-28
+  { UINT64_C(0xbce5086492111aeb),  -130 }, // 1e-20
+  { UINT64_C(0x8cbccc096f5088cc),  -103 }, // 1e-12
+  { UINT64_C(0xd1b71758e219652c),   -77 }, // 1e-4
+  { UINT64_C(0x9c40000000000000),   -50 }, // 1e4
+  { UINT64_C(0xe8d4a51000000000),   -24 }, // 1e12
+  { UINT64_C(0xad78ebc5ac620000),     3 }, // 1e20
+  { UINT64_C(0x813f3978f8940984),    30 }, // 1e28
+  { UINT64_C(0xc097ce7bc90715b3),    56 }, // 1e36
+  { UINT64_C(0x8f7e32ce7bea5c70),    83 }, // 1e44
+  { UINT64_C(0xd5d238a4abe98068),   109 }, // 1e52
+  { UINT64_C(0x9f4f2726179a2245),   136 }, // 1e60
+  { UINT64_C(0xed63a231d4c4fb27),   162 }, // 1e68
+  { UINT64_C(0xb0de65388cc8ada8),   189 }, // 1e76
+  { UINT64_C(0x83c7088e1aab65db),   216 }, // 1e84
+  { UINT64_C(0xc45d1df942711d9a),   242 }, // 1e92
+  { UINT64_C(0x924d692ca61be758),   269 }, // 1e100
+  { UINT64_C(0xda01ee641a708dea),   295 }, // 1e108
+  { UINT64_C(0xa26da3999aef774a),   322 }, // 1e116
+  { UINT64_C(0xf209787bb47d6b85),   348 }, // 1e124
+  { UINT64_C(0xb454e4a179dd1877),   375 }, // 1e132
+  { UINT64_C(0x865b86925b9bc5c2),   402 }, // 1e140
+  { UINT64_C(0xc83553c5c8965d3d),   428 }, // 1e148
+  { UINT64_C(0x952ab45cfa97a0b3),   455 }, // 1e156
+  { UINT64_C(0xde469fbd99a05fe3),   481 }, // 1e164
+  { UINT64_C(0xa59bc234db398c25),   508 }, // 1e172
+  { UINT64_C(0xf6c69a72a3989f5c),   534 }, // 1e180
+  { UINT64_C(0xb7dcbf5354e9bece),   561 }, // 1e188
+  { UINT64_C(0x88fcf317f22241e2),   588 }, // 1e196
+  { UINT64_C(0xcc20ce9bd35c78a5),   614 }, // 1e204
+  { UINT64_C(0x98165af37b2153df),   641 }, // 1e212
+  { UINT64_C(0xe2a0b5dc971f303a),   667 }, // 1e220
+  { UINT64_C(0xa8d9d1535ce3b396),   694 }, // 1e228
+  { UINT64_C(0xfb9b7cd9a4a7443c),   720 }, // 1e236
+  { UINT64_C(0xbb764c4ca7a44410),   747 }, // 1e244
+  { UINT64_C(0x8bab8eefb6409c1a),   774 }, // 1e252
+  { UINT64_C(0xd01fef10a657842c),   800 }, // 1e260
+  { UINT64_C(0x9b10a4e5e9913129),   827 }, // 1e268
+  { UINT64_C(0xe7109bfba19c0c9d),   853 }, // 1e276
+  { UINT64_C(0xac2820d9623bf429),   880 }, // 1e284
+  { UINT64_C(0x80444b5e7aa7cf85),   907 }, // 1e292
+  { UINT64_C(0xbf21e44003acdd2d),   933 }, // 1e300
+  { UINT64_C(0x8e679c2f5e44ff8f),   960 }, // 1e308
+  { UINT64_C(0xd433179d9c8cb841),   986 }, // 1e316
+  { UINT64_C(0x9e19db92b4e31ba9),  1013 }, // 1e324
+  { UINT64_C(0xeb96bf6ebadf77d9),  1039 }, // 1e332
+  { UINT64_C(0xaf87023b9bf0ee6b),  1066 }, // 1e340
+};
+
+#define QIO_NUM_CACHED_POW10 (int)(sizeof(_qio_cached_pow10)/sizeof(_qio_cached_pow10[0]))
+
+static const uint64_t _qio_uint_pow10[] = {
+  UINT64_C(1), UINT64_C(10), UINT64_C(100), UINT64_C(1000),
+  UINT64_C(10000), UINT64_C(100000), UINT64_C(1000000),
+  UINT64_C(10000000), UINT64_C(100000000), UINT64_C(1000000000),
+  UINT64_C(10000000000), UINT64_C(100000000000),
+  UINT64_C(1000000000000), UINT64_C(10000000000000),
+  UINT64_C(100000000000000), UINT64_C(1000000000000000),
+  UINT64_C(10000000000000000), UINT64_C(100000000000000000),
+  UINT64_C(1000000000000000000), UINT64_C(10000000000000000000)
+};
+
+// 64x64->128 bit multiply, returning the high half in *hi.
+static inline uint64_t _qio_mul64(uint64_t a, uint64_t b, uint64_t* hi)
+{
+  uint64_t a_lo = a & 0xffffffffu, a_hi = a >> 32;
+  uint64_t b_lo = b & 0xffffffffu, b_hi = b >> 32;
+  uint64_t ll = a_lo * b_lo;
+  uint64_t lh = a_lo * b_hi;
+  uint64_t hl = a_hi * b_lo;
+  uint64_t hh = a_hi * b_hi;
+  uint64_t mid = (ll >> 32) + (lh & 0xffffffffu) + (hl & 0xffffffffu);
+  *hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+  return (mid << 32) | (ll & 0xffffffffu);
+}
+
+// Gets 10^q as a normalized f * 2^e accurate to about 2^-63.
+static int _qio_get_pow10(int q, uint64_t* f, int* e)
+{
+  int idx, r;
+  uint64_t hi, lo, small;
+  int small_e;
+
+  if( q < QIO_CACHED_POW10_MIN ) return 0;
+  idx = (q - QIO_CACHED_POW10_MIN) / QIO_CACHED_POW10_STEP;
+  if( idx >= QIO_NUM_CACHED_POW10 ) return 0;
+  r = q - (QIO_CACHED_POW10_MIN + idx * QIO_CACHED_POW10_STEP);
+
+  *f = _qio_cached_pow10[idx].f;
+  *e = _qio_cached_pow10[idx].e;
+  if( r == 0 ) return 1;
+
+  // 10^r for r < 8 fits in 27 bits, so normalizing it is exact.
+  small = _qio_uint_pow10[r];
+  small_e = 0;
+  while( !(small & (UINT64_C(1) << 63)) ) {
+    small <<= 1;
+    small_e--;
+  }
+
+  lo = _qio_mul64(*f, small, &hi);
+  *e += small_e + 64;
+  if( !(hi & (UINT64_C(1) << 63)) ) {
+    hi = (hi << 1) | (lo >> 63);
+    lo <<= 1;
+    *e -= 1;
+  }
+  // round to nearest
+  if( lo & (UINT64_C(1) << 63) ) {
+    hi++;
+    if( hi == 0 ) {
+      hi = UINT64_C(1) << 63;
+      *e += 1;
+    }
+  }
+  *f = hi;
+  return 1;
+}
+
+// Sets *out to v * 10^q rounded to the nearest integer, which must be
+// less than 10^18. v must be positive and finite. Returns 0 if that
+// can't be done, or if v * 10^q is too close to halfway between two
+// integers for the approximate power of ten to tell which is nearer;
+// the caller should then fall back to snprintf.
+static int _qio_round_scaled(double v, int q, uint64_t* out)
+{
+  union { double d; uint64_t u; } bits;
+  uint64_t f, p, hi, frac, half;
+  int e, pe, shift;
+
+  bits.d = v;
+  f = bits.u & ((UINT64_C(1) << 52) - 1);
+  e = (int) ((bits.u >> 52) & 0x7ff);
+  if( e == 0 ) {
+    e = -1074;
+  } else {
+    f |= UINT64_C(1) << 52;
+    e -= 1075;
+  }
+  if( f == 0 ) return 0;
+  while( !(f & (UINT64_C(1) << 63)) ) {
+    f <<= 1;
+    e--;
+  }
+
+  if( !_qio_get_pow10(q, &p, &pe) ) return 0;
+
+  // v * 10^q ~= (hi:lo) * 2^(e+pe), and (hi:lo) is off by at most
+  // 2^65, i.e. 2 in hi.
+  (void) _qio_mul64(f, p, &hi);
+  shift = -(e + pe);
+  if( shift < 64 + 4 || shift >= 128 ) return 0;
+  shift -= 64;
+
+  *out = hi >> shift;
+  if( *out >= _qio_uint_pow10[18] ) return 0;
+
+  frac = hi & ((UINT64_C(1) << shift) - 1);
+  half = UINT64_C(1) << (shift - 1);
+  if( frac + 4 < half ) {
+    // round down
+  } else if( frac >= half + 4 ) {
+    *out += 1;
+  } else {
+    return 0;
+  }
+  return 1;
+}
+
+// Gets the first ndigits significant digits of v, correctly rounded,
+// along with the decimal exponent of the first one.
+static int _qio_float_digits(double v, int ndigits, uint64_t* digits, int* exp10)
+{
+  union { double d; uint64_t u; } bits;
+  int e2, x, tries;
+  uint64_t d;
+
+  bits.d = v;
+  e2 = (int) ((bits.u >> 52) & 0x7ff);
+  if( e2 == 0 ) {
+    // subnormal: find the top bit
+    uint64_t f = bits.u & ((UINT64_C(1) << 52) - 1);
+    for( e2 = -1075; f != 0; f >>= 1 ) e2++;
+  } else {
+    e2 -= 1023;
+  }
+  // x = floor(e2 * log10(2)), computed exactly for |e2| < 1650. Since
+  // 2^e2 <= v, x is never too big, and at most one too small. It
+  // mustn't be too big: then a number that should get another digit
+  // could round up to 10^(ndigits-1) and look right.
+  if( e2 >= 0 ) x = (e2 * 78913) >> 18;
+  else x = -((-e2 * 78913 + 262143) >> 18);
+
+  for( tries = 0; tries < 3; tries++ ) {
+    if( !_qio_round_scaled(v, ndigits - 1 - x, &d) ) return 0;
+    if( d < _qio_uint_pow10[ndigits] ) break;
+    // x was one too small, or the digits rounded up to 10^ndigits.
+    x++;
+  }
+  if( tries == 3 || d < _qio_uint_pow10[ndigits - 1] ) return 0;
+
+  *digits = d;
+  *exp10 = x;
+  return 1;
+}
+
+// Writes the ndigits decimal digits of d to dst, with leading zeros.
+static void _qio_put_digits(char* dst, uint64_t d, int ndigits)
+{
+  int i;
+  for( i = ndigits - 1; i >= 0; i-- ) {
+    dst[i] = '0' + (d % 10);
+    d /= 10;
+  }
+}
+
+// Formats num, which must be positive, like snprintf would with a %e
+// (realfmt 2), %f (realfmt 1), or %g (realfmt 0) conversion with the
+// given precision, the # flag if showpoint is set, and uppercase
+// letters if uppercase is set. Returns what snprintf would, or -1 if
+// snprintf needs to do the work; that's the case for zero, infinity,
+// NaN, more than 17 significant digits, and the rare numbers that
+// fall too close to a rounding boundary.
+static int _qio_dtoa_fast(char* restrict dst, size_t size, double num,
+                          int realfmt, int precision,
+                          int showpoint, int uppercase)
+{
+  char tmp[64];
+  uint64_t d;
+  int n = 0;
+  int ndigits, x, i;
+  int fprec;
+  int exponential;
+  int strip = 0;
+
+  if( !(num > 0) || isinf(num) ) return -1;
+  if( precision < 0 ) precision = 6;
+
+  if( realfmt == 1 ) {
+    // %f: the digits are num*10^precision rounded to an integer.
+    if( precision > 17 ) return -1;
+    if( !_qio_round_scaled(num, precision, &d) ) return -1;
+    for( ndigits = 1; ndigits < 18 && d >= _qio_uint_pow10[ndigits]; ndigits++ ) ;
+    if( ndigits < precision + 1 ) ndigits = precision + 1;
+    _qio_put_digits(tmp, d / _qio_uint_pow10[precision], ndigits - precision);
+    n = ndigits - precision;
+    if( precision > 0 || showpoint ) tmp[n++] = '.';
+    _qio_put_digits(tmp + n, d % _qio_uint_pow10[precision], precision);
+    n += precision;
+  } else if( realfmt == 0 || realfmt == 2 ) {
+    if( realfmt == 2 ) ndigits = precision + 1;
+    else ndigits = (precision == 0) ? 1 : precision;
+    if( ndigits > 17 ) return -1;
+    if( !_qio_float_digits(num, ndigits, &d, &x) ) return -1;
+
+    exponential = 1;
+    if( realfmt == 0 ) {
+      // glibc's %#g prints a number that rounded up to a power of ten,
+      // e.g. 999.9 with %#.3g, with no digits after the point.
+      if( showpoint && d == _qio_uint_pow10[ndigits - 1] ) return -1;
+      strip = !showpoint;
+      if( ndigits > x && x >= -4 ) exponential = 0;
+    }
+
+    if( exponential ) {
+      tmp[n++] = '0' + (char) (d / _qio_uint_pow10[ndigits - 1]);
+      if( ndigits > 1 || showpoint ) tmp[n++] = '.';
+      _qio_put_digits(tmp + n, d % _qio_uint_pow10[ndigits - 1], ndigits - 1);
+      n += ndigits - 1;
+    } else {
+      fprec = ndigits - 1 - x;
+      if( x >= 0 ) {
+        _qio_put_digits(tmp, d, ndigits);
+        n = x + 1;
+        if( fprec > 0 || showpoint ) {
+          for( i = ndigits; i > n; i-- ) tmp[i] = tmp[i - 1];
+          tmp[n] = '.';
+          n = ndigits + 1;
+        }
+      } else {
+        tmp[n++] = '0';
+        tmp[n++] = '.';
+        for( i = 0; i < -x - 1; i++ ) tmp[n++] = '0';
+        _qio_put_digits(tmp + n, d, ndigits);
+        n += ndigits;
+      }
+    }
+
+    if( strip ) {
+      // %g without # drops trailing zeros after the point, and the
+      // point itself if nothing is left after it.
+      for( i = 0; i < n && tmp[i] != '.'; i++ ) ;
+      if( i < n ) {
+        while( tmp[n - 1] == '0' ) n--;
+        if( tmp[n - 1] == '.' ) n--;
+      }
+    }
+
+    if( exponential ) {
+      int ax = (x < 0) ? -x : x;
+      tmp[n++] = uppercase ? 'E' : 'e';
+      tmp[n++] = (x < 0) ? '-' : '+';
+      if( ax >= 100 ) tmp[n++] = '0' + ax / 100;
+      tmp[n++] = '0' + (ax / 10) % 10;
+      tmp[n++] = '0' + ax % 10;
+    }
+  } else {
+    return -1;
+  }
+
+  if( (size_t) n < size ) {
+    qio_memcpy(dst, tmp, n);
+    dst[n] = '\0';
+  }
+  return n;
+}
+
 // error codes:
 //  -1 for out of memory
 //  -2 for error in conversion
@@ -2243,7 +2712,15 @@ int _ftoa(char* restrict dst, size_t size, double num, int base, bool needs_i, c
     //       style->base, style->realfmt, precision, style->uppercase, style->showpoint);
 
     // Figure out how big our output is...
-    if( style->base == 16 ) {
+    got = -1;
+    if( style->base != 16 ) {
+      got = _qio_dtoa_fast(buf, buf_sz, num, style->realfmt, precision,
+                           style->showpoint, style->uppercase);
+    }
+
+    if( got >= 0 ) {
+      // the fast path handled it
+    } else if( style->base == 16 ) {
       if( precision < 0 ) {
         if( style->uppercase ) {
           if( style->showpoint )
@@ -2477,61 +2954,41 @@ int _ftoa(char* restrict dst, size_t size, double num, int base, bool needs_i, c
   return i;
 }
 
-// TODO -- support max_width
-qioerr qio_channel_print_int(const int threadsafe, qio_channel_t* restrict ch, const void* restrict ptr, size_t len, int issigned)
+// Reads the integer of len bytes at ptr, returning its magnitude in
+// *num and whether it is negative in *isneg.
+static
+qioerr _qio_load_int(const void* restrict ptr, size_t len, int issigned, uint64_t* restrict num, int* restrict isneg)
 {
-  uint64_t num=0;
-  int64_t num_s=0;
-  int isneg;
-  int max = 70; // room enough for binary output. (1 '\0', 2 0b, 1 +-, 64 bits)
+  int64_t num_s = 0;
   int signed_len;
-  int base;
-  char* tmp = NULL;
-  MAYBE_STACK_SPACE(char, tmp_onstack);
-  int got;
   qioerr err;
-  qio_style_t* style;
-
-  if( threadsafe ) {
-    err = qio_lock(&ch->lock);
-    if( err ) {
-      return err;
-    }
-  }
-
-  style = &ch->style;
-
-  if( style->min_width_columns + 1 > max ) max = style->min_width_columns + 1;
-
-  base = style->base;
-  if( base == 0 ) base = 10;
 
   signed_len = len;
   if( issigned ) signed_len = -signed_len;
 
-  // Read the number we're printing.
   err = 0;
+  *num = 0;
   switch( signed_len ) {
     case -1:
       num_s = *(int8_t*) ptr;
       break;
     case 1:
-      num = *(uint8_t*) ptr;
+      *num = *(uint8_t*) ptr;
       break;
     case -2:
       num_s = *(int16_t*) ptr;
       break;
     case 2:
-      num = *(uint16_t*) ptr;
+      *num = *(uint16_t*) ptr;
       break;
     case 4:
-      num = *(uint32_t*) ptr;
+      *num = *(uint32_t*) ptr;
       break;
     case -4:
       num_s = *(int32_t*) ptr;
       break;
     case 8:
-      num = *(uint64_t*) ptr;
+      *num = *(uint64_t*) ptr;
       break;
     case -8:
       num_s = *(int64_t*) ptr;
@@ -2539,18 +2996,51 @@ qioerr qio_channel_print_int(const int threadsafe, qio_channel_t* restrict ch, c
     default:
       QIO_GET_CONSTANT_ERROR(err, EINVAL, "bad integer type");
   }
-  if( err ) goto error;
 
-  isneg = 0;
+  *isneg = 0;
   if( issigned ) {
     if (num_s < 0 ) {
-      isneg = 1;
-      num = - num_s;
+      *isneg = 1;
+      *num = - num_s;
     } else {
-      num = num_s;
+      *num = num_s;
     }
   }
 
+  return err;
+}
+
+// TODO -- support max_width
+qioerr qio_channel_print_int(const int threadsafe, qio_channel_t* restrict ch, const void* restrict ptr, size_t len, int issigned)
+{
+  uint64_t num=0;
+  int isneg;
+  int max = 70; // room enough for binary output. (1 '\0', 2 0b, 1 +-, 64 bits)
+  int base;
+  char* tmp = NULL;
+  MAYBE_STACK_SPACE(char, tmp_onstack);
+  int got;
+  qioerr err;
+  qio_style_t* style;
+
+  if( threadsafe ) {
+    err = qio_lock(&ch->lock);
+    if( err ) {
+      return err;
+    }
+  }
+
+  style = &ch->style;
+
+  if( style->min_width_columns + 1 > max ) max = style->min_width_columns + 1;
+
+  base = style->base;
+  if( base == 0 ) base = 10;
+
+  // Read the number we're printing.
+  err = _qio_load_int(ptr, len, issigned, &num, &isneg);
+  if( err ) goto error;
+
   // Try printing it directly into the buffer.
   if( VOID_PTR_DIFF(ch->cached_end,ch->cached_cur) > max ) {
     // Print it all directly into the buffer.
@@ -2721,6 +3211,215 @@ qioerr qio_channel_print_imag(const int threadsafe, qio_channel_t* restrict ch,
   return qio_channel_print_float_or_imag(threadsafe, ch, ptr, len, true);
 }
 
+// The array printing functions format numbers into a buffer on the
+// stack and write it to the channel when it fills up.
+#define QIO_PRINT_ARRAY_CHUNK 4096
+
+static
+qioerr _qio_channel_print_array_unlocked(qio_channel_t* restrict ch, const void* restrict ptr, size_t len, int issigned, bool isfloat, ssize_t nmemb, const char* restrict sep, ssize_t seplen)
+{
+  char chunk[QIO_PRINT_ARRAY_CHUNK];
+  ssize_t used = 0;
+  ssize_t i;
+  int base;
+  int got;
+  qioerr err = 0;
+  qioerr flush_err;
+  qio_style_t* style;
+
+  style = &ch->style;
+  base = style->base;
+  if( base == 0 ) base = 10;
+
+  for( i = 0; i < nmemb; i++ ) {
+    const void* elt = VOID_PTR_ADD(ptr, i * len);
+    uint64_t num = 0;
+    int isneg = 0;
+    double fnum = 0.0;
+
+    if( isfloat ) {
+      switch (len) {
+        case 4:
+          fnum = *(float*) elt;
+          break;
+        case 8:
+          fnum = *(double*) elt;
+          break;
+        default:
+          QIO_GET_CONSTANT_ERROR(err, EINVAL, "bad floating point type");
+      }
+    } else {
+      err = _qio_load_int(elt, len, issigned, &num, &isneg);
+    }
+    if( err ) goto error;
+
+    if( i > 0 && seplen > 0 ) {
+      if( seplen > QIO_PRINT_ARRAY_CHUNK - used ) {
+        err = qio_channel_write_amt(false, ch, chunk, used);
+        used = 0;
+        if( err ) goto error;
+      }
+      if( seplen > QIO_PRINT_ARRAY_CHUNK ) {
+        err = qio_channel_write_amt(false, ch, sep, seplen);
+        if( err ) goto error;
+      } else {
+        qio_memcpy(chunk + used, sep, seplen);
+        used += seplen;
+      }
+    }
+
+    while( 1 ) {
+      if( isfloat ) {
+        got = _ftoa(chunk + used, QIO_PRINT_ARRAY_CHUNK - used, fnum, base, false, style);
+        if( got < 0 ) {
+          if( got == -1 ) err = QIO_ENOMEM;
+          else QIO_GET_CONSTANT_ERROR(err, EINVAL, "converting floating point number to string");
+          goto error;
+        }
+      } else {
+        got = _ltoa(chunk + used, QIO_PRINT_ARRAY_CHUNK - used, num, isneg, base, style);
+        if( got < 0 ) {
+          QIO_GET_CONSTANT_ERROR(err, EINVAL, "unknown base or bad width");
+          goto error;
+        }
+      }
+
+      if( got < QIO_PRINT_ARRAY_CHUNK - used ) {
+        used += got;
+        break;
+      } else if( used == 0 ) {
+        // It doesn't fit even in an empty chunk (e.g. because of a
+        // large width), so print it the usual way.
+        if( isfloat ) err = qio_channel_print_float(false, ch, elt, len);
+        else err = qio_channel_print_int(false, ch, elt, len, issigned);
+        if( err ) goto error;
+        break;
+      } else {
+        // Not enough room left; write out the chunk and try again.
+        err = qio_channel_write_amt(false, ch, chunk, used);
+        used = 0;
+        if( err ) goto error;
+      }
+    }
+  }
+
+error:
+  // Write out the numbers before any error, as printing them one at
+  // a time would have.
+  if( used > 0 ) {
+    flush_err = qio_channel_write_amt(false, ch, chunk, used);
+    if( ! err ) err = flush_err;
+  }
+
+  return err;
+}
+
+static
+qioerr _qio_channel_scan_array_unlocked(qio_channel_t* restrict ch, void* restrict out, size_t len, int issigned, bool isfloat, ssize_t nmemb, const char* restrict sep, ssize_t seplen, int skipws)
+{
+  ssize_t i;
+  qioerr err = 0;
+
+  for( i = 0; i < nmemb; i++ ) {
+    void* elt = VOID_PTR_ADD(out, i * len);
+
+    if( i > 0 && seplen > 0 ) {
+      err = qio_channel_scan_literal(false, ch, sep, seplen, skipws);
+      if( err ) break;
+    }
+
+    if( isfloat ) err = qio_channel_scan_float(false, ch, elt, len);
+    else err = qio_channel_scan_int(false, ch, elt, len, issigned);
+    if( err ) break;
+  }
+
+  return err;
+}
+
+qioerr qio_channel_print_int_array(const int threadsafe, qio_channel_t* restrict ch, const void* restrict ptr, size_t len, int issigned, ssize_t nmemb, const char* restrict sep, ssize_t seplen)
+{
+  qioerr err;
+
+  if( threadsafe ) {
+    err = qio_lock(&ch->lock);
+    if( err ) {
+      return err;
+    }
+  }
+
+  err = _qio_channel_print_array_unlocked(ch, ptr, len, issigned, false, nmemb, sep, seplen);
+
+  _qio_channel_set_error_unlocked(ch, err);
+  if( threadsafe ) {
+    qio_unlock(&ch->lock);
+  }
+
+  return err;
+}
+
+qioerr qio_channel_print_float_array(const int threadsafe, qio_channel_t* restrict ch, const void* restrict ptr, size_t len, ssize_t nmemb, const char* restrict sep, ssize_t seplen)
+{
+  qioerr err;
+
+  if( threadsafe ) {
+    err = qio_lock(&ch->lock);
+    if( err ) {
+      return err;
+    }
+  }
+
+  err = _qio_channel_print_array_unlocked(ch, ptr, len, false, true, nmemb, sep, seplen);
+
+  _qio_channel_set_error_unlocked(ch, err);
+  if( threadsafe ) {
+    qio_unlock(&ch->lock);
+  }
+
+  return err;
+}
+
+qioerr qio_channel_scan_int_array(const int threadsafe, qio_channel_t* restrict ch, void* restrict out, size_t len, int issigned, ssize_t nmemb, const char* restrict sep, ssize_t seplen, int skipws)
+{
+  qioerr err;
+
+  if( threadsafe ) {
+    err = qio_lock(&ch->lock);
+    if( err ) {
+      return err;
+    }
+  }
+
+  err = _qio_channel_scan_array_unlocked(ch, out, len, issigned, false, nmemb, sep, seplen, skipws);
+
+  _qio_channel_set_error_unlocked(ch, err);
+  if( threadsafe ) {
+    qio_unlock(&ch->lock);
+  }
+
+  return err;
+}
+
+qioerr qio_channel_scan_float_array(const int threadsafe, qio_channel_t* restrict ch, void* restrict out, size_t len, ssize_t nmemb, const char* restrict sep, ssize_t seplen, int skipws)
+{
+  qioerr err;
+
+  if( threadsafe ) {
+    err = qio_lock(&ch->lock);
+    if( err ) {
+      return err;
+    }
+  }
+
+  err = _qio_channel_scan_array_unlocked(ch, out, len, false, true, nmemb, sep, seplen, skipws);
+
+  _qio_channel_set_error_unlocked(ch, err);
+  if( threadsafe ) {
+    qio_unlock(&ch->lock);
+  }
+
+  return err;
+}
+
 
 qioerr qio_channel_scan_complex(const int threadsafe, qio_channel_t* restrict ch, void* restrict re_out, void* restrict im_out, size_t len)
 {
@@ -4106,6 +4805,85 @@ done:
   return err;
 }
 
+// The conversions parsed from literal format strings. Entries are
+// claimed from a fixed array and never removed, since the formats
+// they describe live as long as the program. Lookups don't lock: an
+// entry is filled in before it is pushed on its bucket's list and
+// isn't changed after that. Two tasks missing on the same conversion
+// at once may both add it, which is harmless.
+#define QIO_CONV_CACHE_SIZE 1024
+#define QIO_CONV_CACHE_BUCKETS 256
+
+typedef struct qio_conv_cache_entry_s {
+  const char* fmt;
+  size_t start;
+  int scanning;
+  uint64_t end;
+  qio_conv_t spec;
+  qio_style_t style;
+  struct qio_conv_cache_entry_s* next;
+} qio_conv_cache_entry_t;
+
+static qio_conv_cache_entry_t qio_conv_cache_entries[QIO_CONV_CACHE_SIZE];
+static atomic_uint_least64_t qio_conv_cache_used;
+static atomic_uintptr_t qio_conv_cache_buckets[QIO_CONV_CACHE_BUCKETS];
+
+void qio_conv_cache_init(void)
+{
+  int i;
+  atomic_init_uint_least64_t(&qio_conv_cache_used, 0);
+  for( i = 0; i < QIO_CONV_CACHE_BUCKETS; i++ ) {
+    atomic_init_uintptr_t(&qio_conv_cache_buckets[i], 0);
+  }
+}
+
+qioerr qio_conv_parse_static(c_string fmt,
+                             size_t start,
+                             uint64_t* end,
+                             int scanning,
+                             qio_conv_t* spec_out,
+                             qio_style_t* style_out)
+{
+  uintptr_t h = ((uintptr_t) fmt + start) * 0x9e3779b1u;
+  atomic_uintptr_t* bucket = &qio_conv_cache_buckets[(h >> 8) % QIO_CONV_CACHE_BUCKETS];
+  qio_conv_cache_entry_t* e;
+  uintptr_t head;
+  uint_least64_t slot;
+  qioerr err;
+
+  for( e = (qio_conv_cache_entry_t*) atomic_load_uintptr_t(bucket);
+       e != NULL;
+       e = e->next ) {
+    if( e->fmt == fmt && e->start == start && e->scanning == scanning ) {
+      *spec_out = e->spec;
+      *style_out = e->style;
+      *end = e->end;
+      return 0;
+    }
+  }
+
+  err = qio_conv_parse(fmt, start, end, scanning, spec_out, style_out);
+  if( err ) return err;
+
+  // Once the table is full, later formats are just parsed every time.
+  slot = atomic_fetch_add_uint_least64_t(&qio_conv_cache_used, 1);
+  if( slot >= QIO_CONV_CACHE_SIZE ) return 0;
+
+  e = &qio_conv_cache_entries[slot];
+  e->fmt = fmt;
+  e->start = start;
+  e->scanning = scanning;
+  e->end = *end;
+  e->spec = *spec_out;
+  e->style = *style_out;
+  do {
+    head = atomic_load_uintptr_t(bucket);
+    e->next = (qio_conv_cache_entry_t*) head;
+  } while( ! atomic_compare_exchange_strong_uintptr_t(bucket, head, (uintptr_t) e) );
+
+  return 0;
+}
+
 qioerr qio_format_error_too_many_args(void)
 {
   qioerr err;
@@ -28,6 +28,7 @@
 #include "chplexit.h"
 #include "chpl-locale-model.h"
 #include "chpl-mem.h"
+#include "chpl-mem-pool.h"
 #include "chpl-tasks.h"
 #include "chplsys.h"
 #include "error.h"
@@ -42,9 +43,10 @@
 
 
 //
-// task pool: linked list of tasks
+// task pool: linked lists of tasks, one per task queue
 //
 typedef struct task_pool_struct* task_pool_p;
+typedef struct task_queue_struct* task_queue_p;
 
 typedef struct {
   chpl_task_prvData_t prvdata;
@@ -64,6 +66,20 @@ typedef struct task_pool_struct {
 } task_pool_t;
 
 
+//
+// The task pool is split into task queues, each with its own lock.  A
+// thread adds the tasks it creates to its home queue, so threads
+// creating tasks at the same time do not contend with each other.  An
+// idle thread starts the oldest task in its home queue, or if that is
+// empty, steals the oldest task from one of the other queues.
+//
+typedef struct task_queue_struct {
+  chpl_thread_mutex_t  lock;     // protects the queue and its tasks
+  volatile task_pool_p head;     // oldest task in the queue
+  volatile task_pool_p tail;     // newest task in the queue
+} task_queue_t;
+
+
 // This struct is intended for use in a circular linked list where the pointer
 // to the list actually points to the tail of the list, i.e., the last entry
 // inserted into the list, making it easier to append items to the end of the list.
@@ -74,6 +90,7 @@ struct chpl_task_list {
   void* arg;
   chpl_task_prvDataImpl_t chpl_data;
   volatile task_pool_p ptask; // when null, execution of the associated task has begun
+  task_queue_p queue;         // the queue ptask was added to
   c_string filename;
   int lineno;
   chpl_task_list_p next;
@@ -103,6 +120,7 @@ typedef struct lockReport {
 // This is the data that is private to each thread.
 typedef struct {
   task_pool_p   ptask;
+  task_queue_p  queue;        // home queue for the tasks this thread creates
   lockReport_t* lockRprt;
 } thread_private_data_t;
 
@@ -111,24 +129,28 @@ static chpl_bool        initialized = false;
 
 static volatile chpl_bool canCountRunningTasks = false;
 
-static chpl_thread_mutex_t threading_lock;     // critical section lock
+static chpl_thread_mutex_t threading_lock;     // thread creation lock
 static chpl_thread_mutex_t extra_task_lock;    // critical section lock
 static chpl_thread_mutex_t task_id_lock;       // critical section lock
 static chpl_thread_mutex_t task_list_lock;     // critical section lock
-static volatile task_pool_p
-                           task_pool_head;     // head of task pool
-static volatile task_pool_p
-                           task_pool_tail;     // tail of task pool
-
-static int                 queued_task_cnt;    // number of tasks in task pool
-static int                 running_task_cnt;   // number of running tasks
+static task_queue_p        task_queues;        // task pool
+static int                 num_task_queues;    // number of task queues
+static atomic_int_least32_t
+                           next_task_queue;    // next home queue to assign
+
+static atomic_int_least32_t
+                           queued_task_cnt;    // number of tasks in task pool
+static atomic_int_least32_t
+                           running_task_cnt;   // number of running tasks
 static int64_t             extra_task_cnt;     // number of tasks being run by
                                                //   threads occupied already
-static int                 waking_thread_cnt;  // number of threads created but
-                                               //   not yet running
+static atomic_int_least32_t
+                           waking_thread_cnt;  // number of idle threads
+                                               //   expected to find work soon
 static int                 blocked_thread_cnt; // number of threads that
                                                //   cannot make progress
-static int                 idle_thread_cnt;    // number of threads looking
+static atomic_int_least32_t
+                           idle_thread_cnt;    // number of threads looking
                                                //   for work
 static uint64_t            progress_cnt;       // number of unblock operations,
                                                //   as a proxy for progress
@@ -148,6 +170,8 @@ static void                    comm_task_wrapper(void*);
 static void                    movedTaskWrapper(void* a);
 static chpl_taskID_t           get_next_task_id(void);
 static thread_private_data_t*  get_thread_private_data(void);
+static task_queue_p            assign_task_queue(void);
+static task_queue_p            get_home_queue(void);
 static task_pool_p             get_current_ptask(void);
 static void                    set_current_ptask(task_pool_p);
 static void                    report_locked_threads(void);
@@ -162,9 +186,14 @@ static void                    thread_end(void);
 static void                    begin_task(chpl_fn_p, void*,
                                           chpl_task_prvDataImpl_t,
                                           chpl_task_list_p);
-static void                    launch_next_task_in_new_thread(void);
-static void                    schedule_next_task(int);
-static task_pool_p             add_to_task_pool(chpl_fn_p,
+static void                    launch_next_task_in_new_thread(task_queue_p);
+static void                    schedule_next_task(task_queue_p, int);
+static void                    release_waking_thread(void);
+static task_pool_p             dequeue_task(task_queue_p);
+static task_pool_p             take_task(task_queue_p);
+static void                    unlink_task(task_queue_p, task_pool_p);
+static task_pool_p             add_to_task_pool(task_queue_p,
+                                                chpl_fn_p,
                                                 void*,
                                                 chpl_task_prvDataImpl_t,
                                                 chpl_task_list_p);
@@ -178,17 +207,79 @@ static void chpl_thread_condvar_init(chpl_thread_condvar_t* cv);
 // Sync variable methods
 //
 static chpl_bool chpl_thread_sync_suspend(chpl_sync_aux_t *s,
-                                   struct timeval *deadline);
+                                          int_least32_t want,
+                                          struct timeval *deadline);
 static void chpl_thread_sync_awaken(chpl_sync_aux_t *s);
 
 // Sync variables
 
+//
+// The state word of a sync variable holds its full/empty bit and a
+// lock bit.  Taking the lock, conditionally on the full/empty bit if
+// the caller cares, is a single compare-and-swap; releasing it is a
+// store.  A task that can't get the lock spins for a while and then,
+// if the hardware is oversubscribed, waits on a condition variable
+// (otherwise it yields, as before).  Waiting tasks are counted, so the
+// release path only touches the mutex and the condvars when somebody
+// is actually waiting.
+//
+// These use the compiler's __sync builtins directly rather than the
+// Chapel atomics, because the lock-based implementation of the latter
+// is itself built on sync variables.
+//
+#define SYNC_FULL        0x1
+#define SYNC_LOCKED      0x2
+#define SYNC_ANY         (-1)    // want: don't care whether full or empty
+#define SYNC_SPIN_COUNT  100
+
+static inline chpl_bool sync_is_ready(chpl_sync_aux_t *s, int_least32_t want) {
+  int_least32_t state = s->state;
+
+  return ((state & SYNC_LOCKED) == 0
+          && (want == SYNC_ANY || (state & SYNC_FULL) == want));
+}
+
+static inline chpl_bool sync_try_lock(chpl_sync_aux_t *s, int_least32_t want) {
+  int_least32_t state = s->state;
+
+  if ((state & SYNC_LOCKED) != 0
+      || (want != SYNC_ANY && (state & SYNC_FULL) != want))
+    return false;
+  return __sync_bool_compare_and_swap(&s->state, state, state | SYNC_LOCKED);
+}
+
+static inline chpl_bool sync_spin_lock(chpl_sync_aux_t *s, int_least32_t want) {
+  int i;
+
+  for (i = 0; i < SYNC_SPIN_COUNT; i++) {
+    if (sync_try_lock(s, want))
+      return true;
+  }
+  return false;
+}
+
+static inline void sync_release(chpl_sync_aux_t *s, int_least32_t state) {
+  // Publish the caller's updates to the value, then the new state, and
+  // only then look for waiters; a waiter counts itself before it checks
+  // the state, so one of the two sees the other.
+  __sync_synchronize();
+  s->state = state;
+  __sync_synchronize();
+  if (s->waiters > 0)
+    chpl_thread_sync_awaken(s);
+}
+
 static void sync_wait_and_lock(chpl_sync_aux_t *s,
                                chpl_bool want_full,
                                int32_t lineno, c_string filename) {
+  int_least32_t want = want_full ? SYNC_FULL : 0;
   chpl_bool suspend_using_cond;
 
-  chpl_thread_mutexLock(&s->lock);
+  if (sync_try_lock(s, want) || sync_spin_lock(s, want)) {
+    if (blockreport)
+      progress_cnt++;
+    return;
+  }
 
   // If we're oversubscribing the hardware, we wait using conditionals
   // in order to ensure fairness and thus progress.  If we're not, we
@@ -196,10 +287,7 @@ static void sync_wait_and_lock(chpl_sync_aux_t *s,
   suspend_using_cond = (chpl_thread_getNumThreads() >=
                         chpl_getNumLogicalCpus(true));
 
-  while (s->is_full != want_full) {
-    if (!suspend_using_cond) {
-      chpl_thread_mutexUnlock(&s->lock);
-    }
+  while (!sync_try_lock(s, want)) {
     if (set_block_loc(lineno, filename)) {
       // all other tasks appear to be blocked
       struct timeval deadline, now;
@@ -211,31 +299,29 @@ static void sync_wait_and_lock(chpl_sync_aux_t *s,
       deadline.tv_sec += 1;
       do {
         if (suspend_using_cond)
-          timed_out = chpl_thread_sync_suspend(s, &deadline);
+          timed_out = chpl_thread_sync_suspend(s, want, &deadline);
         else
           chpl_thread_yield();
         
-        if (s->is_full != want_full && !timed_out)
+        if (!sync_is_ready(s, want) && !timed_out)
           gettimeofday(&now, NULL);
-      } while (s->is_full != want_full
+      } while (!sync_is_ready(s, want)
                && !timed_out
                && (now.tv_sec < deadline.tv_sec
                    || (now.tv_sec == deadline.tv_sec
                        && now.tv_usec < deadline.tv_usec)));
-      if (s->is_full != want_full)
+      if (!sync_is_ready(s, want))
         check_for_deadlock();
     }
     else {
       do {
         if (suspend_using_cond)
-          (void) chpl_thread_sync_suspend(s, NULL);
+          (void) chpl_thread_sync_suspend(s, want, NULL);
         else
           chpl_thread_yield();
-      } while (s->is_full != want_full);
+      } while (!sync_is_ready(s, want));
     }
     unset_block_loc();
-    if (!suspend_using_cond)
-      chpl_thread_mutexLock(&s->lock);
   }
 
   if (blockreport)
@@ -243,11 +329,14 @@ static void sync_wait_and_lock(chpl_sync_aux_t *s,
 }
 
 void chpl_sync_lock(chpl_sync_aux_t *s) {
-  chpl_thread_mutexLock(&s->lock);
+  if (sync_try_lock(s, SYNC_ANY) || sync_spin_lock(s, SYNC_ANY))
+    return;
+  while (!sync_try_lock(s, SYNC_ANY))
+    chpl_thread_yield();
 }
 
 void chpl_sync_unlock(chpl_sync_aux_t *s) {
-  chpl_thread_mutexUnlock(&s->lock);
+  sync_release(s, s->state & ~SYNC_LOCKED);
 }
 
 void chpl_sync_waitFullAndLock(chpl_sync_aux_t *s,
@@ -261,44 +350,55 @@ void chpl_sync_waitEmptyAndLock(chpl_sync_aux_t *s,
 }
 
 static chpl_bool chpl_thread_sync_suspend(chpl_sync_aux_t *s,
-                                   struct timeval *deadline) {
+                                          int_least32_t want,
+                                          struct timeval *deadline) {
   chpl_thread_condvar_t* cond;
-  cond = s->is_full ? &s->signal_empty : &s->signal_full;
+  chpl_bool timed_out = false;
 
-  if (deadline == NULL) {
-    (void) pthread_cond_wait(cond, (pthread_mutex_t*) &s->lock);
-    return false;
-  }
-  else {
-    struct timespec ts;
-    ts.tv_sec  = deadline->tv_sec;
-    ts.tv_nsec = deadline->tv_usec * 1000UL;
-    return (pthread_cond_timedwait(cond, (pthread_mutex_t*) &s->lock, &ts)
-            == ETIMEDOUT);
+  cond = (want == SYNC_FULL) ? &s->signal_full : &s->signal_empty;
+
+  (void) __sync_fetch_and_add(&s->waiters, 1);
+  chpl_thread_mutexLock(&s->lock);
+
+  if (!sync_is_ready(s, want)) {
+    if (deadline == NULL) {
+      (void) pthread_cond_wait(cond, (pthread_mutex_t*) &s->lock);
+    }
+    else {
+      struct timespec ts;
+      ts.tv_sec  = deadline->tv_sec;
+      ts.tv_nsec = deadline->tv_usec * 1000UL;
+      timed_out = (pthread_cond_timedwait(cond, (pthread_mutex_t*) &s->lock,
+                                          &ts)
+                   == ETIMEDOUT);
+    }
   }
+
+  chpl_thread_mutexUnlock(&s->lock);
+  (void) __sync_fetch_and_sub(&s->waiters, 1);
+
+  return timed_out;
 }
 
 static void chpl_thread_sync_awaken(chpl_sync_aux_t *s) {
-  if (pthread_cond_signal(s->is_full ?
+  chpl_thread_mutexLock(&s->lock);
+  if (pthread_cond_signal((s->state & SYNC_FULL) ?
                           &s->signal_full : &s->signal_empty))
     chpl_internal_error("pthread_cond_signal() failed");
+  chpl_thread_mutexUnlock(&s->lock);
 }
 
 void chpl_sync_markAndSignalFull(chpl_sync_aux_t *s) {
-  s->is_full = true;
-  chpl_thread_sync_awaken(s);
-  chpl_sync_unlock(s);
+  sync_release(s, SYNC_FULL);
 }
 
 void chpl_sync_markAndSignalEmpty(chpl_sync_aux_t *s) {
-  s->is_full = false;
-  chpl_thread_sync_awaken(s);
-  chpl_sync_unlock(s);
+  sync_release(s, 0);
 }
 
 chpl_bool chpl_sync_isFull(void *val_ptr,
                             chpl_sync_aux_t *s) {
-  return s->is_full;
+  return (s->state & SYNC_FULL) != 0;
 }
 
 static void chpl_thread_condvar_init(chpl_thread_condvar_t* cv) {
@@ -307,7 +407,8 @@ static void chpl_thread_condvar_init(chpl_thread_condvar_t* cv) {
 }
 
 void chpl_sync_initAux(chpl_sync_aux_t *s) {
-  s->is_full = false;
+  s->state = 0;
+  s->waiters = 0;
   chpl_thread_mutexInit(&s->lock);
   chpl_thread_condvar_init(&s->signal_full);
   chpl_thread_condvar_init(&s->signal_empty);
@@ -322,16 +423,38 @@ void chpl_task_init(void) {
   chpl_thread_mutexInit(&extra_task_lock);
   chpl_thread_mutexInit(&task_id_lock);
   chpl_thread_mutexInit(&task_list_lock);
-  queued_task_cnt = 0;
-  running_task_cnt = 1;                     // only main task running
-  waking_thread_cnt = 0;
+  atomic_init_int_least32_t(&queued_task_cnt, 0);
+  atomic_init_int_least32_t(&running_task_cnt, 1); // only main task running
+  atomic_init_int_least32_t(&waking_thread_cnt, 0);
   blocked_thread_cnt = 0;
-  idle_thread_cnt = 0;
+  atomic_init_int_least32_t(&idle_thread_cnt, 0);
   extra_task_cnt = 0;
-  task_pool_head = task_pool_tail = NULL;
 
   chpl_thread_init(thread_begin, thread_end);
 
+  //
+  // Create one task queue for each thread that can run in parallel.
+  // This has to wait until the threading layer knows its limits.
+  //
+  {
+    int i;
+
+    num_task_queues = (int) chpl_task_getMaxPar();
+    if (num_task_queues < 1)
+      num_task_queues = 1;
+
+    task_queues = (task_queue_p) chpl_mem_allocMany(num_task_queues,
+                                                    sizeof(task_queue_t),
+                                                    CHPL_RT_MD_TASK_POOL_DESCRIPTOR,
+                                                    0, 0);
+    for (i = 0; i < num_task_queues; i++) {
+      chpl_thread_mutexInit(&task_queues[i].lock);
+      task_queues[i].head = task_queues[i].tail = NULL;
+    }
+
+    atomic_init_int_least32_t(&next_task_queue, 0);
+  }
+
   //
   // Set main thread private data, so that things that require access
   // to it, like chpl_task_getID() and chpl_task_setSerial(), can be
@@ -360,6 +483,7 @@ void chpl_task_init(void) {
     tp->ptask->filename     = "main program";
     tp->ptask->lineno       = 0;
     tp->ptask->next         = NULL;
+    tp->queue               = assign_task_queue();
     tp->lockRprt            = NULL;
 
     // Set up task-private data for locale (architectural) support.
@@ -463,6 +587,7 @@ static void comm_task_wrapper(void* arg) {
   //
   tp->ptask->chpl_data.prvdata.serial_state = true;
 
+  tp->queue    = assign_task_queue();
   tp->lockRprt = NULL;
 
   chpl_thread_setPrivateData(tp);
@@ -486,14 +611,16 @@ void chpl_task_addToTaskList(chpl_fn_int_t fid, void* arg,
   if (task_list_locale == chpl_nodeID) {
     chpl_task_list_p ltask;
 
-    ltask = (chpl_task_list_p) chpl_mem_alloc(sizeof(struct chpl_task_list),
-                                              CHPL_RT_MD_TASK_LIST_DESCRIPTOR,
-                                              0, 0);
+    ltask = (chpl_task_list_p)
+            chpl_mem_pool_alloc(sizeof(struct chpl_task_list),
+                                CHPL_RT_MD_TASK_LIST_DESCRIPTOR,
+                                0, 0);
     ltask->filename = filename;
     ltask->lineno   = lineno;
     ltask->fun      = chpl_ftable[fid];
     ltask->arg      = arg;
     ltask->ptask    = NULL;
+    ltask->queue    = NULL;
     ltask->chpl_data = chpl_data;
 
     if (is_begin_stmt)
@@ -555,13 +682,15 @@ void chpl_task_processTaskList(chpl_task_list_p task_list) {
 
     if (first_task != task_list) {
       // there are at least two tasks in task_list
+      task_queue_p queue = get_home_queue();
 
       // begin critical section
-      chpl_thread_mutexLock(&threading_lock);
+      chpl_thread_mutexLock(&queue->lock);
 
       do {
         ltask = next_task;
-        ltask->ptask = add_to_task_pool(ltask->fun, ltask->arg,
+        ltask->queue = queue;
+        ltask->ptask = add_to_task_pool(queue, ltask->fun, ltask->arg,
                                         ltask->chpl_data, ltask);
         assert(ltask->ptask == NULL
                || ltask->ptask->ltask == ltask);
@@ -569,10 +698,10 @@ void chpl_task_processTaskList(chpl_task_list_p task_list) {
         task_cnt++;
       } while (ltask != task_list);
 
-      schedule_next_task(task_cnt);
-
       // end critical section
-      chpl_thread_mutexUnlock(&threading_lock);
+      chpl_thread_mutexUnlock(&queue->lock);
+
+      schedule_next_task(queue, task_cnt);
     }
 
     // Execute the first task on the list, since it has to run to completion
@@ -652,13 +781,14 @@ void chpl_task_executeTasksInList(chpl_task_list_p task_list) {
     // don't lock unless it looks like we will find a task to execute
     // if we do so
     if (ltask->ptask) {
+      task_queue_p queue = ltask->queue;
       task_pool_p  curr_ptask;
       task_pool_p  nested_ptask = NULL;
       chpl_fn_p    task_to_run_fun = NULL;
       void*        task_to_run_arg = NULL;
 
       // begin critical section
-      chpl_thread_mutexLock(&threading_lock);
+      chpl_thread_mutexLock(&queue->lock);
 
       if (ltask->ptask) {
         assert(!ltask->ptask->begun);
@@ -671,27 +801,14 @@ void chpl_task_executeTasksInList(chpl_task_list_p task_list) {
         // will eventually be freed
         nested_ptask = ltask->ptask;
         ltask->ptask = NULL;
-        if (waking_thread_cnt > 0)
-          waking_thread_cnt--;
-        assert(queued_task_cnt > 0);
-        queued_task_cnt--;
-        if (nested_ptask->prev == NULL) {
-          if ((task_pool_head = nested_ptask->next) == NULL)
-            task_pool_tail = NULL;
-          else
-            task_pool_head->prev = NULL;
-        }
-        else {
-          nested_ptask->prev->next = nested_ptask->next;
-          if (nested_ptask->next == NULL)
-            task_pool_tail = nested_ptask->prev;
-          else
-            nested_ptask->next->prev = nested_ptask->prev;
-        }
+        release_waking_thread();
+        assert(atomic_load_int_least32_t(&queued_task_cnt) > 0);
+        atomic_fetch_sub_int_least32_t(&queued_task_cnt, 1);
+        unlink_task(queue, nested_ptask);
       }
 
       // end critical section
-      chpl_thread_mutexUnlock(&threading_lock);
+      chpl_thread_mutexUnlock(&queue->lock);
 
       if (task_to_run_fun) {
         curr_ptask = get_current_ptask();
@@ -733,7 +850,7 @@ void chpl_task_executeTasksInList(chpl_task_list_p task_list) {
         chpl_thread_mutexUnlock(&extra_task_lock);
 
         set_current_ptask(curr_ptask);
-        chpl_mem_free(nested_ptask, 0, 0);
+        chpl_mem_pool_free(nested_ptask, sizeof(task_pool_t), 0, 0);
       }
     }
 
@@ -756,7 +873,7 @@ void chpl_task_freeTaskList(chpl_task_list_p task_list) {
   do {
     ltask = next_task;
     next_task = ltask->next;
-    chpl_mem_free(ltask, 0, 0);
+    chpl_mem_pool_free(ltask, sizeof(struct chpl_task_list), 0, 0);
   } while (ltask != task_list);
 }
 
@@ -767,6 +884,7 @@ void chpl_task_startMovedTask(chpl_fn_p fp,
                               chpl_taskID_t id,
                               chpl_bool serial_state) {
   movedTaskWrapperDesc_t* pmtwd;
+  task_queue_p queue;
   chpl_task_prvDataImpl_t private = {
     .prvdata = { .serial_state = serial_state } };
 
@@ -774,21 +892,25 @@ void chpl_task_startMovedTask(chpl_fn_p fp,
   assert(id == chpl_nullTaskID);
 
   pmtwd = (movedTaskWrapperDesc_t*)
-          chpl_mem_alloc(sizeof(*pmtwd),
-                         CHPL_RT_MD_THREAD_PRIVATE_DATA,
-                         0, 0);
+          chpl_mem_pool_alloc(sizeof(*pmtwd),
+                              CHPL_RT_MD_THREAD_PRIVATE_DATA,
+                              0, 0);
   *pmtwd = (movedTaskWrapperDesc_t)
            { fp, a, canCountRunningTasks,
              private };
 
+  queue = get_home_queue();
+
   // begin critical section
-  chpl_thread_mutexLock(&threading_lock);
+  chpl_thread_mutexLock(&queue->lock);
 
-  (void) add_to_task_pool(movedTaskWrapper, pmtwd, pmtwd->chpl_data, NULL);
-  schedule_next_task(1);
+  (void) add_to_task_pool(queue, movedTaskWrapper, pmtwd, pmtwd->chpl_data,
+                          NULL);
 
   // end critical section
-  chpl_thread_mutexUnlock(&threading_lock);
+  chpl_thread_mutexUnlock(&queue->lock);
+
+  schedule_next_task(queue, 1);
 }
 
 
@@ -799,7 +921,7 @@ static void movedTaskWrapper(void* a) {
   (pmtwd->fp)(pmtwd->arg);
   if (pmtwd->countRunning)
     chpl_taskRunningCntDec(0, NULL);
-  chpl_mem_free(pmtwd, 0, 0);
+  chpl_mem_pool_free(pmtwd, sizeof(*pmtwd), 0, 0);
 }
 
 
@@ -870,7 +992,9 @@ size_t chpl_task_getCallStackSize(void) {
   return chpl_thread_getCallStackSize();
 }
 
-uint32_t chpl_task_getNumQueuedTasks(void) { return queued_task_cnt; }
+uint32_t chpl_task_getNumQueuedTasks(void) {
+  return atomic_load_int_least32_t(&queued_task_cnt);
+}
 
 uint32_t chpl_task_getNumRunningTasks(void) {
   chpl_internal_error("chpl_task_getNumRunningTasks() called");
@@ -882,17 +1006,19 @@ int32_t  chpl_task_getNumBlockedTasks(void) {
     int numBlockedTasks;
 
     // begin critical section
-    chpl_thread_mutexLock(&threading_lock);
     chpl_thread_mutexLock(&block_report_lock);
 
-    numBlockedTasks = blocked_thread_cnt - idle_thread_cnt;
+    numBlockedTasks = blocked_thread_cnt
+                      - atomic_load_int_least32_t(&idle_thread_cnt);
 
     // end critical section
     chpl_thread_mutexUnlock(&block_report_lock);
-    chpl_thread_mutexUnlock(&threading_lock);
 
-    assert(numBlockedTasks >= 0);
-    return numBlockedTasks;
+    //
+    // The idle thread count is not protected by the block report lock,
+    // so a thread going idle can briefly make this look negative.
+    //
+    return (numBlockedTasks > 0) ? numBlockedTasks : 0;
   }
   else
     return 0;
@@ -978,19 +1104,22 @@ static void report_locked_threads(void) {
 // pending tasks and those that are running.
 //
 static void report_all_tasks(void) {
-    task_pool_p pendingTask = task_pool_head;
+    int i;
 
     printf("Task report\n");
     printf("--------------------------------\n");
 
     // print out pending tasks
     printf("Pending tasks:\n");
-    while(pendingTask != NULL) {
-        if(! pendingTask->begun) {
-            printf("- %s:%d\n", pendingTask->filename,
-                   (int)pendingTask->lineno);
+    for (i = 0; i < num_task_queues; i++) {
+        task_pool_p pendingTask = task_queues[i].head;
+        while(pendingTask != NULL) {
+            if(! pendingTask->begun) {
+                printf("- %s:%d\n", pendingTask->filename,
+                       (int)pendingTask->lineno);
+            }
+            pendingTask = pendingTask->next;
         }
-        pendingTask = pendingTask->next;
     }
     printf("\n");
 
@@ -1150,6 +1279,7 @@ thread_begin(void* ptask_void) {
                                                CHPL_RT_MD_THREAD_PRIVATE_DATA,
                                                0, 0);
   tp->ptask    = ptask;
+  tp->queue    = assign_task_queue();
   tp->lockRprt = NULL;
   chpl_thread_setPrivateData(tp);
 
@@ -1171,31 +1301,22 @@ thread_begin(void* ptask_void) {
       chpl_thread_mutexUnlock(&taskTable_lock);
     }
 
-    // begin critical section
-    chpl_thread_mutexLock(&threading_lock);
-
     //
-    // We have to wait to free the ptask until we hold the lock, in
-    // order to make sure launch_next_task_in_new_thread() is done
-    // manipulating the ptask before anyone else could re-allocate it.
-    // We could do the free before grabbing the lock if we arranged for
-    // launch_next_task_in_new_thread() to do the pool manipulations
-    // before calling chpl_thread_create(), but then we would also have
-    // to be prepared to undo all those manipulations if we were unable
-    // to create a thread.
+    // The ptask was unlinked from its queue before this thread got it,
+    // so nobody else can be looking at it any more.
     //
     tp->ptask = NULL;
-    chpl_mem_free(ptask, 0, 0);
+    chpl_mem_pool_free(ptask, sizeof(task_pool_t), 0, 0);
 
     //
     // finished task; decrement running count and increment idle count
     //
-    assert(running_task_cnt > 0);
-    running_task_cnt--;
-    idle_thread_cnt++;
+    assert(atomic_load_int_least32_t(&running_task_cnt) > 0);
+    atomic_fetch_sub_int_least32_t(&running_task_cnt, 1);
+    atomic_fetch_add_int_least32_t(&idle_thread_cnt, 1);
 
     //
-    // wait for a not-yet-begun task to be present in the task pool
+    // wait for a not-yet-begun task to be present in some task queue
     //
 
     // In revision 22137, we investigated whether it was beneficial to
@@ -1208,75 +1329,45 @@ thread_begin(void* ptask_void) {
     // that were waiting on the signal, but since there was a performance
     // impact from keeping it as a hybrid as opposed to merely yielding,
     // it was decided that we would return to the simple yield case.
-    while (!task_pool_head) {
-      chpl_thread_mutexUnlock(&threading_lock);
-      while (!task_pool_head) {
-        if (set_block_loc(0, idleTaskName)) {
-          // all other tasks appear to be blocked
-          struct timeval deadline, now;
-          gettimeofday(&deadline, NULL);
-          deadline.tv_sec += 1;
-          do {
-            chpl_thread_yield();
-            if (!task_pool_head)
-              gettimeofday(&now, NULL);
-          } while (!task_pool_head
-                   && (now.tv_sec < deadline.tv_sec
-                       || (now.tv_sec == deadline.tv_sec
-                           && now.tv_usec < deadline.tv_usec)));
-          if (!task_pool_head) {
-            check_for_deadlock();
-          }
-        }
-        else {
-          do {
-            chpl_thread_yield();              
-          } while (!task_pool_head);
+    while ((ptask = take_task(tp->queue)) == NULL) {
+      if (set_block_loc(0, idleTaskName)) {
+        // all other tasks appear to be blocked
+        struct timeval deadline, now;
+        gettimeofday(&deadline, NULL);
+        deadline.tv_sec += 1;
+        do {
+          chpl_thread_yield();
+          if (atomic_load_int_least32_t(&queued_task_cnt) == 0)
+            gettimeofday(&now, NULL);
+        } while (atomic_load_int_least32_t(&queued_task_cnt) == 0
+                 && (now.tv_sec < deadline.tv_sec
+                     || (now.tv_sec == deadline.tv_sec
+                         && now.tv_usec < deadline.tv_usec)));
+        if (atomic_load_int_least32_t(&queued_task_cnt) == 0) {
+          check_for_deadlock();
         }
-
-        unset_block_loc();
       }
-      chpl_thread_mutexLock(&threading_lock);
-    }
+      else {
+        do {
+          chpl_thread_yield();
+        } while (atomic_load_int_least32_t(&queued_task_cnt) == 0);
+      }
 
+      unset_block_loc();
+    }
 
     if (blockreport)
       progress_cnt++;
 
-    assert(task_pool_head && !task_pool_head->begun);
-
-    if (waking_thread_cnt > 0)
-      waking_thread_cnt--;
+    release_waking_thread();
 
     //
-    // start new task; increment running count and remove task from pool
-    // also add to task to task-table (structure in ChapelRuntime that keeps
-    // track of currently running tasks for task-reports on deadlock or
-    // Ctrl+C).
+    // start new task; take_task() has already removed it from its queue
+    // and adjusted the queued count
     //
-    assert(queued_task_cnt > 0);
-    queued_task_cnt--;
-    idle_thread_cnt--;
-    running_task_cnt++;
-    ptask = task_pool_head;
-    if (ptask->ltask) {
-      ptask->ltask->ptask = NULL;
-      // there is no longer any need to access the corresponding task
-      // list entry so avoid any potential of accessing a node that
-      // will eventually be freed
-      ptask->ltask = NULL;
-    }
+    atomic_fetch_sub_int_least32_t(&idle_thread_cnt, 1);
+    atomic_fetch_add_int_least32_t(&running_task_cnt, 1);
     tp->ptask = ptask;
-    ptask->begun = true;
-    task_pool_head = task_pool_head->next;
-    if (task_pool_head == NULL)  // task pool is now empty
-      task_pool_tail = NULL;
-    else {
-      task_pool_head->prev = NULL;
-    }
-
-    // end critical section
-    chpl_thread_mutexUnlock(&threading_lock);
   }
 }
 
@@ -1311,51 +1402,197 @@ void begin_task(chpl_fn_p fp, void* a, chpl_task_prvDataImpl_t chpl_data,
   if (chpl_data.prvdata.serial_state)
     (*fp)(a);
   else {
+    task_queue_p queue = get_home_queue();
     task_pool_p ptask = NULL;
 
     // begin critical section
-    chpl_thread_mutexLock(&threading_lock);
+    chpl_thread_mutexLock(&queue->lock);
 
-    ptask = add_to_task_pool(fp, a, chpl_data, ltask);
+    ptask = add_to_task_pool(queue, fp, a, chpl_data, ltask);
 
     //
-    // This task may begin executing before returning from this function,
-    // so the task list node needs to be updated before there is any
-    // possibility of launching this task (inside the critical section).
+    // This task may be stolen as soon as the queue is unlocked, so the
+    // task list node needs to be updated inside the critical section.
     //
-    if (ltask)
+    if (ltask) {
+      ltask->queue = queue;
       ltask->ptask = ptask;
-
-    schedule_next_task(1);
+    }
 
     assert(ptask->ltask == NULL
            || (ptask->ltask == ltask
                && ltask->ptask == ptask));
 
     // end critical section
-    chpl_thread_mutexUnlock(&threading_lock);
+    chpl_thread_mutexUnlock(&queue->lock);
+
+    schedule_next_task(queue, 1);
   }
 }
 
 
+//
+// Hand out home queues to threads round-robin.
+//
+static task_queue_p assign_task_queue(void) {
+  int i = atomic_fetch_add_int_least32_t(&next_task_queue, 1);
+  return &task_queues[(unsigned int) i % num_task_queues];
+}
+
+
+//
+// New tasks go on the queue of the thread creating them.  Threads the
+// tasking layer didn't create for itself have no private data and use
+// the first queue.
+//
+static task_queue_p get_home_queue(void) {
+  thread_private_data_t* tp =
+    (thread_private_data_t*) chpl_thread_getPrivateData();
+  return (tp && tp->queue) ? tp->queue : &task_queues[0];
+}
+
+
+//
+// Remove a task from a queue.
+// assumes queue->lock has already been acquired!
+//
+static void unlink_task(task_queue_p queue, task_pool_p ptask) {
+  if (ptask->prev == NULL) {
+    if ((queue->head = ptask->next) == NULL)
+      queue->tail = NULL;
+    else
+      queue->head->prev = NULL;
+  }
+  else {
+    ptask->prev->next = ptask->next;
+    if (ptask->next == NULL)
+      queue->tail = ptask->prev;
+    else
+      ptask->next->prev = ptask->prev;
+  }
+}
+
+
+//
+// Dequeue the task at the head of the given queue and mark it begun.
+// assumes queue->lock has already been acquired!
+//
+static task_pool_p dequeue_task(task_queue_p queue) {
+  task_pool_p ptask = queue->head;
+
+  if (ptask == NULL)
+    return NULL;
+
+  assert(!ptask->begun);
+  assert(atomic_load_int_least32_t(&queued_task_cnt) > 0);
+  atomic_fetch_sub_int_least32_t(&queued_task_cnt, 1);
+  if (ptask->ltask) {
+    ptask->ltask->ptask = NULL;
+    // there is no longer any need to access the corresponding task
+    // list entry so avoid any potential of accessing a node that
+    // will eventually be freed
+    ptask->ltask = NULL;
+  }
+  ptask->begun = true;
+  unlink_task(queue, ptask);
+  return ptask;
+}
+
+
+//
+// Find a task for an idle thread: first from the head of its home
+// queue, then by stealing from the heads of the other queues in turn.
+// The unlocked emptiness checks keep idle threads from contending for
+// the locks of empty queues.
+//
+static task_pool_p take_task(task_queue_p home) {
+  int first = (int) (home - task_queues);
+  int i;
+
+  for (i = 0; i < num_task_queues; i++) {
+    task_queue_p queue = &task_queues[(first + i) % num_task_queues];
+    task_pool_p  ptask;
+
+    if (queue->head == NULL)
+      continue;
+
+    // begin critical section
+    chpl_thread_mutexLock(&queue->lock);
+
+    ptask = dequeue_task(queue);
+
+    // end critical section
+    chpl_thread_mutexUnlock(&queue->lock);
+
+    if (ptask)
+      return ptask;
+  }
+
+  return NULL;
+}
+
+
+//
+// A thread that was counted as waking up for a task has found one (or
+// the task was run by someone else), so it no longer needs reserving.
+//
+static void release_waking_thread(void) {
+  int32_t cnt = atomic_load_int_least32_t(&waking_thread_cnt);
+
+  while (cnt > 0
+         && !atomic_compare_exchange_strong_int_least32_t(&waking_thread_cnt,
+                                                          cnt, cnt - 1))
+    cnt = atomic_load_int_least32_t(&waking_thread_cnt);
+}
+
+
 //
 // run task in a new thread
-// assumes at least one task is in the pool and threading_lock has already
-// been acquired!
+// assumes threading_lock has already been acquired!
 //
 static void
-launch_next_task_in_new_thread(void) {
+launch_next_task_in_new_thread(task_queue_p queue) {
   task_pool_p       ptask;
   static chpl_bool  warning_issued = false;
 
   if (warning_issued)  // If thread creation failed previously, don't try again
     return;
 
-  if ((ptask = task_pool_head)) {
+  // begin critical section
+  chpl_thread_mutexLock(&queue->lock);
+
+  //
+  // Take the task off the queue before creating the thread, so the new
+  // thread can run and free it without coordinating with us.  If the
+  // thread can't be created, put the task back where it was.
+  //
+  if ((ptask = queue->head)) {
+    chpl_task_list_p ltask = ptask->ltask;
+
+    (void) dequeue_task(queue);
+
+    atomic_fetch_add_int_least32_t(&running_task_cnt, 1);
+
     if (chpl_thread_create(ptask)) {
       int32_t max_threads = chpl_thread_getMaxThreads();
       uint32_t num_threads = chpl_thread_getNumThreads();
       char msg[256];
+
+      atomic_fetch_sub_int_least32_t(&running_task_cnt, 1);
+      atomic_fetch_add_int_least32_t(&queued_task_cnt, 1);
+      ptask->begun = false;
+      if (ltask) {
+        ptask->ltask = ltask;
+        ltask->ptask = ptask;
+      }
+      ptask->prev = NULL;
+      ptask->next = queue->head;
+      if (queue->head)
+        queue->head->prev = ptask;
+      else
+        queue->tail = ptask;
+      queue->head = ptask;
+
       if (max_threads)
         sprintf(msg,
                 "max threads per locale is %" PRId32
@@ -1368,64 +1605,64 @@ launch_next_task_in_new_thread(void) {
                 num_threads);
       chpl_warning(msg, 0, 0);
       warning_issued = true;
-    } else {
-      assert(queued_task_cnt > 0);
-      queued_task_cnt--;
-      running_task_cnt++;
-      if (ptask->ltask) {
-        ptask->ltask->ptask = NULL;
-        // there is no longer any need to access the corresponding task
-        // list entry so avoid any potential of accessing a node that
-        // will eventually be freed
-        ptask->ltask = NULL;
-      }
-      ptask->begun = true;
-      task_pool_head = task_pool_head->next;
-      if (task_pool_head == NULL)  // task pool is now empty
-        task_pool_tail = NULL;
-      else
-        task_pool_head->prev = NULL;
     }
   }
+
+  // end critical section
+  chpl_thread_mutexUnlock(&queue->lock);
 }
 
 
 // Schedule one or more tasks either by signaling an existing thread or by
 // launching new threads if available
-static void schedule_next_task(int howMany) {
+static void schedule_next_task(task_queue_p queue, int howMany) {
+  int32_t idle, waking;
+
   //
   // Reduce the number of new threads to be started, by the number that
   // are already looking for work and will find it very soon.  Try to
   // launch each remaining task in a new thread, up to the maximum number
   // of threads we are supposed to have.
   //
-  if (idle_thread_cnt > waking_thread_cnt) {
+  do {
+    idle = atomic_load_int_least32_t(&idle_thread_cnt);
+    waking = atomic_load_int_least32_t(&waking_thread_cnt);
+    if (idle <= waking)
+      break;
     // increment waking_thread_cnt by the number of idle threads
-    if (idle_thread_cnt - waking_thread_cnt >= howMany) {
-      waking_thread_cnt += howMany;
-      howMany = 0;
-    } else {
-      howMany -= (idle_thread_cnt - waking_thread_cnt);
-      waking_thread_cnt = idle_thread_cnt;
-    }
-  }
+  } while (!atomic_compare_exchange_strong_int_least32_t(
+              &waking_thread_cnt, waking,
+              (idle - waking >= howMany) ? waking + howMany : idle));
+
+  if (idle > waking)
+    howMany -= (idle - waking >= howMany) ? howMany : idle - waking;
+
+  if (howMany == 0 || !chpl_thread_canCreate())
+    return;
 
-  for (; howMany && chpl_thread_canCreate(); howMany--)
-    launch_next_task_in_new_thread();
+  // begin critical section
+  chpl_thread_mutexLock(&threading_lock);
+
+  for (; howMany && queue->head && chpl_thread_canCreate(); howMany--)
+    launch_next_task_in_new_thread(queue);
+
+  // end critical section
+  chpl_thread_mutexUnlock(&threading_lock);
 }
 
 
 // create a task from the given function pointer and arguments
-// and append it to the end of the task pool
-// assumes threading_lock has already been acquired!
-static task_pool_p add_to_task_pool(chpl_fn_p fp,
+// and append it to the end of the given task queue
+// assumes queue->lock has already been acquired!
+static task_pool_p add_to_task_pool(task_queue_p queue,
+                                    chpl_fn_p fp,
                                     void* a,
                                     chpl_task_prvDataImpl_t chpl_data,
                                     chpl_task_list_p ltask) {
   task_pool_p ptask =
-    (task_pool_p) chpl_mem_alloc(sizeof(task_pool_t),
-                                        CHPL_RT_MD_TASK_POOL_DESCRIPTOR,
-                                        0, 0);
+    (task_pool_p) chpl_mem_pool_alloc(sizeof(task_pool_t),
+                                      CHPL_RT_MD_TASK_POOL_DESCRIPTOR,
+                                      0, 0);
   ptask->id           = get_next_task_id();
   ptask->fun          = fp;
   ptask->arg          = a;
@@ -1443,14 +1680,14 @@ static task_pool_p add_to_task_pool(chpl_fn_p fp,
 
   ptask->next = NULL;
 
-  if (task_pool_tail)
-    task_pool_tail->next = ptask;
+  if (queue->tail)
+    queue->tail->next = ptask;
   else
-    task_pool_head = ptask;
-  ptask->prev = task_pool_tail;
-  task_pool_tail = ptask;
+    queue->head = ptask;
+  ptask->prev = queue->tail;
+  queue->tail = ptask;
 
-  queued_task_cnt++;
+  atomic_fetch_add_int_least32_t(&queued_task_cnt, 1);
 
   if (do_taskReport) {
     chpl_thread_mutexLock(&taskTable_lock);
@@ -1473,14 +1710,12 @@ uint32_t chpl_task_getNumThreads(void) {
 uint32_t chpl_task_getNumIdleThreads(void) {
   int numIdleThreads;
 
-  // begin critical section
-  chpl_thread_mutexLock(&threading_lock);
-
-  numIdleThreads = idle_thread_cnt - waking_thread_cnt;
-
-  // end critical section
-  chpl_thread_mutexUnlock(&threading_lock);
+  //
+  // The two counts are read separately, so allow for a thread that
+  // stopped idling between the reads.
+  //
+  numIdleThreads = atomic_load_int_least32_t(&idle_thread_cnt)
+                   - atomic_load_int_least32_t(&waking_thread_cnt);
 
-  assert(numIdleThreads >= 0);
-  return numIdleThreads;
+  return (numIdleThreads > 0) ? numIdleThreads : 0;
 }
@@ -0,0 +1,46 @@
+// Each module below becomes its own C translation unit under --incremental;
+// the program exercises the globals, class ids, virtual methods and task
+// function table that those translation units share through the header.
+module Shapes {
+  var shapesMade: atomic int;
+
+  class Shape {
+    proc area(): real { return 0.0; }
+  }
+
+  class Square: Shape {
+    var side: real;
+    proc area(): real { return side * side; }
+  }
+
+  class Circle: Shape {
+    var radius: real;
+    proc area(): real { return 3.0 * radius * radius; }
+  }
+
+  proc makeShape(i: int): Shape {
+    shapesMade.add(1);
+    if i % 2 == 0 then return new Square(i);
+    else return new Circle(i);
+  }
+}
+
+module multiModule {
+  use Shapes;
+
+  config const n = 4;
+
+  proc main() {
+    var total: sync real = 0.0;
+
+    coforall i in 1..n {
+      const s = makeShape(i);
+      total += s.area();
+      delete s;
+    }
+
+    writeln("total area = ", total.readFF());
+    writeln("shapes made = ", shapesMade.read());
+    writeln("string default = '", "":string, "'");
+  }
+}
@@ -0,0 +1,4 @@
+// See prediff: the profile written by --print-passes-profile is checked
+// rather than the program's output.
+var x = 1;
+writeln(x);
@@ -0,0 +1,31 @@
+//
+// Create enough privatized domains and arrays to fill several segments
+// of the runtime's privatized object table, and make sure each one is
+// still found through its pid afterwards.
+//
+use BlockDist;
+
+config const n = 8;
+config const numObjs = 300;
+
+const Space = {1..n};
+const D = Space dmapped Block(boundingBox=Space);
+
+var Doms: [1..numObjs] domain(1) dmapped Block(boundingBox=Space);
+for i in 1..numObjs do
+  Doms[i] = {1..i % n + 1};
+
+var total = 0;
+for i in 1..numObjs {
+  var A: [Doms[i]] int;
+  forall a in A do
+    a = i;
+  total += + reduce A;
+}
+
+var expected = 0;
+for i in 1..numObjs do
+  expected += i * (i % n + 1);
+
+writeln(if total == expected then "ok" else "mismatch: " + total + " != " + expected);
+writeln(D);
@@ -0,0 +1,37 @@
+//
+// Calls with identical signatures must keep resolving to the function
+// that is visible from each call site and that matches each param value.
+//
+proc f(x: int) { writeln("f(int)"); }
+proc f(x: real) { writeln("f(real)"); }
+
+proc g() {
+  proc f(x: int) { writeln("g's f(int)"); }
+  f(1);
+  {
+    f(2);
+  }
+  f(3.0);
+}
+
+proc k(x: uint(8)) { writeln("k(uint(8))"); }
+proc k(x: real) { writeln("k(real)"); }
+
+proc p(param n: int) where n < 10 { writeln("p small ", n); }
+proc p(param n: int) where n >= 10 { writeln("p large ", n); }
+
+f(1);
+{
+  f(2);
+}
+f(3.0);
+g();
+f(4);
+
+k(1);
+k(1000);
+k(1);
+
+p(1);
+p(20);
+p(1);
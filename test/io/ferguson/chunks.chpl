@@ -0,0 +1,66 @@
+// Checks that file.chunks() splits a file at line boundaries, so that
+// reading the chunks in parallel sees every line exactly once.
+
+config const n = 300;
+
+var f = opentmp();
+{
+  var w = f.writer();
+  for i in 1..n {
+    w.write(i);
+    for 1..i % 37 do w.write(" x");
+    w.writeln();
+  }
+  w.close();
+}
+
+proc check(numChunks: int, start: int(64) = 0, end: int(64) = max(int(64))) {
+  var count: atomic int;
+  var sum: atomic int;
+  forall (s, e) in f.chunks(numChunks=numChunks, start=start, end=end) {
+    for line in f.lines(start=s, end=e) {
+      var r = openmem();
+      var w = r.writer(); w.write(line); w.close();
+      var i: int;
+      r.reader().read(i);
+      count.add(1);
+      sum.add(i);
+    }
+  }
+  var nonEmpty = 0;
+  var last = start;
+  for (s, e) in f.chunks(numChunks=numChunks, start=start, end=end) {
+    if s != last then writeln("gap before ", s);
+    last = e;
+    nonEmpty += 1;
+  }
+  writeln(numChunks, " chunks: ", nonEmpty, " nonempty, ",
+          count.read(), " lines, sum ", sum.read());
+}
+
+check(1);
+check(4);
+check(7);
+check(n * 3);
+
+// A range that starts at a line boundary and ends partway through a line
+check(5, 0, f.length() / 2);
+
+// A file that doesn't end with the delimiter, split on another byte
+var g = opentmp();
+{
+  var w = g.writer();
+  w.write("a;bb;ccc;dddd;eeeee");
+  w.close();
+}
+for (s, e) in g.chunks(delimiter=0x3b, numChunks=3) {
+  var str: string;
+  g.reader(start=s, end=e).readstring(str);
+  writeln((s, e), " ", str);
+}
+
+// An empty file
+var h = opentmp();
+for c in h.chunks() do writeln(c);
+forall c in h.chunks() do writeln(c);
+writeln("done");
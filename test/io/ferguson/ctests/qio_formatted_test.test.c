@@ -627,6 +627,149 @@ void test_printscan_float(void)
 #undef NSTYLES
 }
 
+// Checks that decimal float output matches snprintf and that reading it
+// back matches strtod, for enough numbers to exercise the fast paths
+// as well as their fallbacks.
+void test_printscan_float_libc(void)
+{
+  qioerr err;
+  qio_file_t* f;
+  qio_channel_t* writing;
+  qio_channel_t* reading;
+
+#define NSTYLES 6
+#define NNUMS 2000
+  qio_style_t styles[NSTYLES];
+  const char* fmts[NSTYLES] = { "%g", "%.17g", "%.2f", "%.10e", "%#.4g", "%.3E" };
+  double tricky[] = { 0.5, 2.5, 0.125, 999.95, 999.9999, 0.0005, 1e15 + 0.5,
+                      9.5, 0.1, 1e22, 1e23, 5e-324, 1.7976931348623157e+308,
+                      2.2250738585072014e-308, 123456.5, 0.000099999 };
+  int ntricky = sizeof(tricky) / sizeof(tricky[0]);
+  double* nums;
+  char* expect;
+  char* got;
+  size_t expect_len;
+  ssize_t amt_read;
+  uint64_t seed = 88172645463325252ULL;
+  int i,j,k;
+
+  nums = malloc(NNUMS * sizeof(double));
+  expect = malloc(NNUMS * 400);
+  got = malloc(NNUMS * 400);
+  assert(nums && expect && got);
+
+  for( i = 0; i < NNUMS; i++ ) {
+    uint64_t u;
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    if( i < ntricky ) {
+      nums[i] = tricky[i];
+    } else if( i % 3 == 0 ) {
+      // any finite double
+      u = seed >> 1;
+      memcpy(&nums[i], &u, sizeof(double));
+      if( isnan(nums[i]) || isinf(nums[i]) ) nums[i] = 1.0;
+    } else if( i % 3 == 1 ) {
+      nums[i] = (double) (seed % 1000000) / 1000.0;
+    } else {
+      // short decimals of all sizes
+      nums[i] = (double) (seed % 100000);
+      for( k = (int) ((seed >> 40) % 40) - 20; k > 0; k-- ) nums[i] *= 10;
+      for( ; k < 0; k++ ) nums[i] /= 10;
+    }
+    if( i % 2 ) nums[i] = -nums[i];
+  }
+
+  for( j = 0; j < NSTYLES; j++ ) {
+    qio_style_init_default(&styles[j]);
+    styles[j].showpointzero = 0;
+  }
+  styles[1].precision = 17;
+  styles[2].realfmt = 1;
+  styles[2].precision = 2;
+  styles[3].realfmt = 2;
+  styles[3].precision = 10;
+  styles[4].showpoint = 1;
+  styles[4].precision = 4;
+  styles[5].realfmt = 2;
+  styles[5].precision = 3;
+  styles[5].uppercase = 1;
+
+  for( j = 0; j < NSTYLES; j++ ) {
+    err = qio_file_open_tmp(&f, 0, NULL);
+    assert(!err);
+
+    err = qio_channel_create(&writing, f, QIO_CH_BUFFERED, 0, 1, 0, INT64_MAX, &styles[j]);
+    assert(!err);
+
+    expect_len = 0;
+    for( i = 0; i < NNUMS; i++ ) {
+      err = qio_channel_print_float(true, writing, &nums[i], 8);
+      assert(!err);
+      err = qio_channel_write_amt(true, writing, "\n", 1);
+      assert(!err);
+      expect_len += sprintf(expect + expect_len, fmts[j], nums[i]);
+      expect[expect_len++] = '\n';
+    }
+
+    qio_channel_release(writing);
+    writing = NULL;
+
+    err = qio_channel_create(&reading, f, QIO_CH_BUFFERED, 1, 0, 0, INT64_MAX, &styles[j]);
+    assert(!err);
+    err = qio_channel_read(true, reading, got, NNUMS * 400, &amt_read);
+    assert(qio_err_to_int(err) == EEOF);
+    assert( (size_t) amt_read == expect_len );
+    assert( 0 == memcmp(got, expect, expect_len) );
+    qio_channel_release(reading);
+    reading = NULL;
+
+    err = qio_channel_create(&reading, f, QIO_CH_BUFFERED, 1, 0, 0, INT64_MAX, &styles[j]);
+    assert(!err);
+    {
+      char* p = expect;
+      for( i = 0; i < NNUMS; i++ ) {
+        double got_num = 0;
+        char nl;
+        char* end;
+        double expect_num;
+        int out_of_range;
+
+        errno = 0;
+        expect_num = strtod(p, &end);
+        // e.g. the largest double with %.10e rounds up past it
+        out_of_range = errno == ERANGE && (expect_num == 0 || isinf(expect_num));
+        assert( *end == '\n' );
+        p = end + 1;
+
+        err = qio_channel_scan_float(true, reading, &got_num, 8);
+        if( out_of_range ) {
+          assert( qio_err_to_int(err) == ERANGE );
+        } else {
+          assert(!err);
+          assert( got_num == expect_num );
+        }
+        err = qio_channel_read_amt(true, reading, &nl, 1);
+        assert(!err);
+      }
+    }
+    qio_channel_release(reading);
+    reading = NULL;
+
+    qio_file_release(f);
+    f = NULL;
+  }
+
+  free(nums);
+  free(expect);
+  free(got);
+
+  if( verbose ) printf("PASS: text float I/O vs. libc\n");
+#undef NNUMS
+#undef NSTYLES
+}
+
 void test_verybasic()
 {
 	qio_file_t *f = NULL;
@@ -1439,6 +1582,10 @@ int main(int argc, char** argv)
     }
   }
 
+  // This one is slow with tiny buffers, and doesn't need them.
+  qbytes_iobuf_size = sizes[0];
+  test_printscan_float_libc();
+
   for( int i = 0; sizes[i] != 0; i++ ) {
     qbytes_iobuf_size = sizes[i];
 
@@ -0,0 +1,92 @@
+// Writes and reads arrays of ints and reals as text, including
+// strided, sliced, and multidimensional arrays and a read error.
+
+use IO;
+
+proc roundtrip(A) {
+  var f = opentmp();
+  var w = f.writer();
+  w.writeln(A);
+  w.close();
+  var r = f.reader();
+  var B: A.type;
+
+  r.readln(B);
+  r.close();
+  writeln(typeToString(A.eltType), " ", A.domain, " roundtrip ", && reduce (A == B));
+}
+
+var A1: [1..10] int = [i in 1..10] (i * 37) % 11 - 5;
+writeln(A1);
+roundtrip(A1);
+
+var A8: [0..6] int(8) = [i in 0..6] (i*40 - 120):int(8);
+writeln(A8);
+roundtrip(A8);
+
+var U: [1..5] uint = [i in 1..5] (max(uint) / i:uint);
+writeln(U);
+roundtrip(U);
+
+var R: [1..6] real = [i in 1..6] i / 7.0;
+writeln(R);
+roundtrip(R);
+
+var R32: [1..4] real(32) = [i in 1..4] (i / 3.0):real(32);
+writeln(R32);
+roundtrip(R32);
+
+var M: [1..3, 1..4] real = [(i,j) in {1..3, 1..4}] i * 10 + j / 4.0;
+writeln(M);
+roundtrip(M);
+
+var C: [1..2, 1..3, 1..2] int = [(i,j,k) in {1..2,1..3,1..2}] i*100+j*10+k;
+writeln(C);
+roundtrip(C);
+
+var S: [1..20 by 3] int = [i in 1..20 by 3] i;
+writeln(S);
+roundtrip(S);
+
+var N: [1..10 by -2] int = [i in 1..10 by -2] i;
+writeln(N);
+
+writeln(A1[3..7]);
+writeln(M[2..3, 2..3]);
+writeln(M[1..3, 2]);
+
+var E: [1..0] int;
+writeln(E);
+writeln("[", E, "]");
+
+var I: [1..3] imag = [i in 1..3] (i:imag);
+writeln(I);
+var B: [1..3] bool = [true, false, true];
+writeln(B);
+
+{
+  var sf = opentmp();
+  var st = sf.writer(style=new iostyle(precision=3, realfmt=2));
+  st.writeln(R);
+  st.close();
+  var st2 = sf.writer(start=100, style=new iostyle(min_width_columns=6, base=16));
+  st2.writeln(A1);
+  st2.close();
+  var s: string;
+  var rr = sf.reader();
+  while rr.readline(s) do write(s);
+}
+writef("%ht\n", R);
+writef("%jt\n", A1);
+writef("%t\n", M);
+
+// read with extra whitespace
+var f = opentmp();
+{ var w = f.writer(); w.writeln("  1   2\n 3\t4 5"); w.close(); }
+var D: [1..5] int;
+{ var r = f.reader(); r.read(D); r.close(); }
+writeln(D);
+// read error
+{ var w = f.writer(); w.writeln("1 2 x 4 5"); w.close(); }
+var D2: [1..5] int;
+{ var r = f.reader(); var e:syserr; r.read(D2, error=e); writeln(D2, " ", e != ENOERR); r.close(); }
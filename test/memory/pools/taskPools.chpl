@@ -0,0 +1,14 @@
+//
+// The fifo tasking layer takes its task descriptors from the runtime
+// object pools, so after enough tasks most of them should be reused.
+// The .prediff keeps only the pool report's headings and checks that
+// reuse happened, since the exact counts depend on timing.
+//
+use Memory;
+
+config const n = 100;
+
+for i in 1..n do
+  coforall j in 1..4 do ;
+
+printMemStat();
@@ -0,0 +1,20 @@
+//
+// Each C holds n reals, much more than the sampling interval in
+// memProfile.execopts, so every array is sampled.  The arrays allocated
+// on the first line are kept and should show live memory; those on
+// the second are freed and should not.
+//
+config const n = 10000, iters = 100;
+
+class C {
+  var A: [1..n] real;
+}
+
+var keep: [1..iters] C;
+for i in 1..iters {
+  keep[i] = new C();
+  var tmp = new C();
+  delete tmp;
+}
+
+writeln("kept ", + reduce [c in keep] c.A.size);
@@ -0,0 +1,51 @@
+// Small procedures without the inline keyword are inlined automatically.
+// The results must not change, including when a formal aliases a global
+// that the callee modifies, or when the callee writes to its formal.
+
+record point {
+  var x, y: int;
+}
+
+var counter = 0;
+
+proc norm1(p: point) {
+  return abs(p.x) + abs(p.y);
+}
+
+proc scaled(p: point, k: int) {
+  return new point(p.x * k, p.y * k);
+}
+
+proc bump(ref n: int) {
+  n += 1;
+}
+
+proc readAfterBump(n: int) {
+  counter += 1;
+  return n;
+}
+
+proc countDown(in n: int) {
+  var steps = 0;
+  while n > 0 {
+    n -= 1;
+    steps += 1;
+  }
+  return steps;
+}
+
+var total = 0;
+for i in 1..10 {
+  const p = new point(i, -i);
+  total += norm1(scaled(p, 2));
+}
+writeln("total = ", total);
+
+var m = 5;
+bump(m);
+writeln("m = ", m);
+
+writeln("readAfterBump = ", readAfterBump(counter), ", counter = ", counter);
+
+const start = 7;
+writeln("countDown = ", countDown(start), ", start = ", start);
@@ -0,0 +1,41 @@
+// Copy propagation run on several threads should produce the same program
+// as the serial pass.
+
+proc sumTo(n: int) {
+  var total = 0;
+  for i in 1..n {
+    const x = i;
+    const y = x;
+    total += y;
+  }
+  return total;
+}
+
+proc swapped(a: int, b: int) {
+  var t = a;
+  var u = b;
+  const v = t;
+  t = u;
+  u = v;
+  return (t, u);
+}
+
+record R {
+  var x: int;
+  var y: real;
+}
+
+proc scaled(r: R, s: real) {
+  var copy = r;
+  const f = s;
+  copy.y = copy.y * f;
+  return copy;
+}
+
+var A: [1..10] int;
+forall i in A.domain do
+  A[i] = sumTo(i);
+
+writeln(A);
+writeln(swapped(1, 2));
+writeln(scaled(new R(3, 1.5), 2.0));
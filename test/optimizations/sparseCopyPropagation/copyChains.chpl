@@ -0,0 +1,42 @@
+// Sparse copy propagation should only forward a copy to the uses it
+// dominates, and only while neither side can have changed.
+
+proc chain(n: int) {
+  const a = n;
+  const b = a;
+  const c = b;
+  return a + b + c;
+}
+
+proc sourceChanges(n: int) {
+  var x = n;
+  const y = x;
+  x = 0;
+  return (x, y);
+}
+
+proc loopCarried(n: int) {
+  var prev = 0;
+  var sum = 0;
+  for i in 1..n {
+    const cur = i;
+    const last = prev;
+    prev = cur;
+    sum += last * 10 + cur;
+  }
+  return sum;
+}
+
+proc onePath(flag: bool, n: int) {
+  var r = 1;
+  if flag {
+    const t = n;
+    r = t;
+  }
+  return r;
+}
+
+writeln(chain(7));
+writeln(sourceChanges(5));
+writeln(loopCarried(4));
+writeln(onePath(true, 9), " ", onePath(false, 9));
@@ -0,0 +1,37 @@
+//
+// Cobegin tasks get their arguments from a bundle in the spawning
+// task's stack frame.  Check that each trip around a loop, each level
+// of recursion and each task of an enclosing coforall sees its own
+// arguments.
+//
+config const n = 1000;
+
+var x, y: int;
+for i in 1..n {
+  cobegin with (ref x, ref y) {
+    x += i;
+    y += 2*i;
+  }
+}
+writeln(x, " ", y);
+
+proc fib(n: int): int {
+  if n < 2 then return n;
+  var p, q: int;
+  cobegin with (ref p, ref q) {
+    p = fib(n-1);
+    q = fib(n-2);
+  }
+  return p + q;
+}
+writeln(fib(15));
+
+var a, b: [1..8] int;
+coforall i in 1..8 with (ref a, ref b) {
+  cobegin {
+    a[i] = i*i;
+    b[i] = -i;
+  }
+}
+writeln(a);
+writeln(b);
@@ -0,0 +1,23 @@
+//
+// A three-stage pipeline connected by sync variables.  Every value has
+// to get through both hand-offs exactly once and in order.
+//
+config const n = 100000;
+
+var stage1, stage2: sync int;
+var sum, count: int;
+var inOrder = true;
+
+cobegin with (ref sum, ref count, ref inOrder) {
+  for i in 1..n do stage1 = i;
+  for 1..n do stage2 = stage1 * 2;
+  for i in 1..n {
+    const v = stage2;
+    if v != 2*i then inOrder = false;
+    sum += v;
+    count += 1;
+  }
+}
+
+writeln(count, " ", sum, " ", inOrder);
+writeln(stage1.isFull, " ", stage2.isFull);
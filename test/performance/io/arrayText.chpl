@@ -0,0 +1,43 @@
+// Writes arrays of ints and reals as text and reads them back.
+
+use Time;
+
+config const n = 1000;
+config const printTiming = false;
+
+proc run(name: string, A: []) {
+  const f = openmem();
+  var t: Timer;
+
+  t.start();
+  var w = f.writer();
+  w.writeln(A);
+  w.close();
+  t.stop();
+  const writeTime = t.elapsed();
+
+  var B: [A.domain] A.eltType;
+  t.clear();
+  t.start();
+  var r = f.reader();
+  r.readln(B);
+  r.close();
+  t.stop();
+  const readTime = t.elapsed();
+
+  writeln(name, " array: ", f.length(), " bytes, sum = ", + reduce B);
+  if printTiming {
+    writeln("write ", name, " array: ", writeTime);
+    writeln("read ", name, " array: ", readTime);
+  }
+
+  f.close();
+}
+
+var I: [1..n] int = [i in 1..n] i * 7919 % 1000003 - 500000;
+var R: [1..n] real = [i in 1..n] i / 8.0;
+var M: [1..n/10, 1..10] int = [(i, j) in {1..n/10, 1..10}] i * 10 + j;
+
+run("int", I);
+run("real", R);
+run("2D int", M);
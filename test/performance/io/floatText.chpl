@@ -0,0 +1,44 @@
+// Writes reals as text with writef and reads them back with readf, in
+// the default, fixed-point, and exponential formats.
+
+use Time;
+
+config const n = 1000;
+config const printTiming = false;
+
+proc run(name: string, fmt: string) {
+  const f = openmem();
+  var t: Timer;
+
+  t.start();
+  var w = f.writer();
+  for i in 1..n do w.writef(fmt, i / 7.0);
+  w.close();
+  t.stop();
+  const writeTime = t.elapsed();
+
+  t.clear();
+  t.start();
+  var r = f.reader();
+  var x: real;
+  var sum = 0.0;
+  for 1..n {
+    r.readf(fmt, x);
+    sum += x;
+  }
+  r.close();
+  t.stop();
+  const readTime = t.elapsed();
+
+  writeln(name, " format: ", f.length(), " bytes, sum = ", sum);
+  if printTiming {
+    writeln("writef ", name, " format: ", writeTime);
+    writeln("readf ", name, " format: ", readTime);
+  }
+
+  f.close();
+}
+
+run("default", "%r\n");
+run("fixed", "%.6dr\n");
+run("exponential", "%.12er\n");
@@ -0,0 +1,60 @@
+// Compares writef and readf with a literal format, whose conversions
+// are parsed once and then looked up, against the same format in a
+// variable, which is parsed again on every call.
+
+use Time;
+
+config const n = 1000;
+config const printTiming = false;
+
+const fmtVar = "%i,%r,%s\n";
+
+proc writeLines(ch, param literal) {
+  for i in 1..n {
+    if literal then ch.writef("%i,%r,%s\n", i, i / 4.0, "abc");
+    else ch.writef(fmtVar, i, i / 4.0, "abc");
+  }
+}
+
+proc readLines(ch, param literal) {
+  var i: int, r: real, s: string;
+  var sum = 0.0;
+  for 1..n {
+    if literal then ch.readf("%i,%r,%s\n", i, r, s);
+    else ch.readf(fmtVar, i, r, s);
+    sum += i + r;
+  }
+  return sum;
+}
+
+proc run(param literal) {
+  const f = openmem();
+  var t: Timer;
+
+  t.start();
+  var w = f.writer();
+  writeLines(w, literal);
+  w.close();
+  t.stop();
+  const writeTime = t.elapsed();
+
+  t.clear();
+  t.start();
+  var r = f.reader();
+  const sum = readLines(r, literal);
+  r.close();
+  t.stop();
+  const readTime = t.elapsed();
+
+  const kind = if literal then "literal" else "variable";
+  writeln(kind, " format: ", f.length(), " bytes, sum = ", sum);
+  if printTiming {
+    writeln("writef ", kind, " format: ", writeTime);
+    writeln("readf ", kind, " format: ", readTime);
+  }
+
+  f.close();
+}
+
+run(literal=false);
+run(literal=true);